@@ -0,0 +1,116 @@
+/**
+ * SPDX-FileComment: Benchmark of heap allocations per query
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file allocations.cpp
+ * @brief Counts the calls to operator new made by one Overpass query through
+ * queryByCoordinates(), streamByCoordinates() and queryByCoordinatesTyped(),
+ * from sending the request to the finished result.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <print>
+#include <string>
+
+#include "PoiOsm.hpp"
+
+namespace {
+
+std::atomic<std::size_t> allocations{0};
+
+struct Count {
+    std::size_t pois = 0;
+    double allocationsPerQuery = 0.0;
+};
+
+// Runs @p query @p queries times; it returns the number of POIs, or 0 on failure
+template <typename Query>
+Count count(int queries, Query query) {
+    std::size_t pois = 0;
+    std::size_t before = allocations.load();
+    for (int i = 0; i < queries; ++i) {
+        pois = query();
+        if (pois == 0) return {};
+    }
+    return {pois, static_cast<double>(allocations.load() - before) / queries};
+}
+
+} // namespace
+
+// libcurl and OpenSSL allocate with malloc, so only the C++ side is counted
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::println(stderr, "usage: {} BASE_URL CA_FILE [QUERIES]", argv[0]);
+        std::println(stderr, "  e.g. {} https://localhost:8443 cert.pem 20 (see https_standin.py, run with 1000 elements)",
+                     argv[0]);
+        return 2;
+    }
+    std::string base = argv[1];
+    int queries = argc > 3 ? std::max(1, std::atoi(argv[3])) : 20;
+
+    // Every query has to parse a response: no result cache
+    PoiOsmClientOptions options;
+    options.overpassEndpoint = base + "/api/interpreter";
+    options.caBundle = argv[2];
+    options.resultCacheCapacity = 0;
+    PoiOsmClient client(options);
+
+    const double lat = 48.1371;
+    const double lon = 11.5754;
+    const int radius = 60000;
+
+    // The first query also sets up the connection
+    if (auto warm = client.queryByCoordinates(lat, lon, radius, {}); !warm) {
+        std::println(stderr, "Query failed: {}", warm.error());
+        return 1;
+    }
+
+    Count json = count(queries, [&]() -> std::size_t {
+        auto result = client.queryByCoordinates(lat, lon, radius, {});
+        return result ? (*result)["results"]["pois"].size() : 0;
+    });
+    Count stream = count(queries, [&]() -> std::size_t {
+        std::size_t pois = 0;
+        auto result = client.streamByCoordinates(lat, lon, radius, {}, [&](const nlohmann::json&) { ++pois; });
+        return result ? pois : 0;
+    });
+    Count typed = count(queries, [&]() -> std::size_t {
+        auto result = client.queryByCoordinatesTyped(lat, lon, radius, {});
+        return result ? result->pois().size() : 0;
+    });
+    if (json.pois == 0 || stream.pois == 0 || typed.pois == 0) {
+        std::println(stderr, "A query failed or returned no POIs");
+        return 1;
+    }
+
+    std::println("operator new calls per query, mean of {} queries against {}", queries, base);
+    std::println("queryByCoordinates       {:5} POIs {:10.1f}", json.pois, json.allocationsPerQuery);
+    std::println("streamByCoordinates      {:5} POIs {:10.1f}", stream.pois, stream.allocationsPerQuery);
+    std::println("queryByCoordinatesTyped  {:5} POIs {:10.1f}", typed.pois, typed.allocationsPerQuery);
+    return 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * SPDX-FileComment: Benchmark of pooled connections against fresh ones
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file connection_reuse.cpp
+ * @brief Measures the latency of queryByAddress() with a fresh client per
+ * query (new DNS lookup, TCP connect and TLS handshake every time) and with
+ * one client whose pool reuses its connections.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <print>
+#include <string>
+#include <vector>
+
+#include "PoiOsm.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Summary {
+    double medianMs;
+    double meanMs;
+};
+
+Summary summarize(std::vector<double> samples) {
+    std::ranges::sort(samples);
+    double sum = 0.0;
+    for (double sample : samples) sum += sample;
+    return {samples[samples.size() / 2], sum / static_cast<double>(samples.size())};
+}
+
+// Milliseconds taken by one geocoded query, or a negative value on failure
+double timeQuery(PoiOsmClient& client) {
+    auto start = Clock::now();
+    auto result = client.queryByAddress("Marienplatz, München", 500, {{"tourism", "viewpoint"}});
+    if (!result) {
+        std::println(stderr, "Query failed: {}", result.error());
+        return -1.0;
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::println(stderr, "usage: {} BASE_URL CA_FILE [QUERIES]", argv[0]);
+        std::println(stderr, "  e.g. {} https://localhost:8443 cert.pem 200 (see https_standin.py)", argv[0]);
+        return 2;
+    }
+    std::string base = argv[1];
+    int queries = argc > 3 ? std::max(1, std::atoi(argv[3])) : 100;
+
+    // Every query has to go to the network: no client-side caches
+    PoiOsmClientOptions options;
+    options.nominatimEndpoint = base + "/search";
+    options.overpassEndpoint = base + "/api/interpreter";
+    options.caBundle = argv[2];
+    options.geocodeCacheCapacity = 0;
+    options.resultCacheCapacity = 0;
+    options.tileCacheCapacity = 0;
+
+    std::vector<double> cold;
+    for (int i = 0; i < queries; ++i) {
+        PoiOsmClient client(options);
+        double ms = timeQuery(client);
+        if (ms < 0) return 1;
+        cold.push_back(ms);
+    }
+
+    PoiOsmClient client(options);
+    double first = timeQuery(client);
+    if (first < 0) return 1;
+    std::vector<double> pooled;
+    for (int i = 0; i < queries; ++i) {
+        double ms = timeQuery(client);
+        if (ms < 0) return 1;
+        pooled.push_back(ms);
+    }
+
+    // Each query is two requests, a Nominatim GET and an Overpass POST
+    Summary fresh = summarize(cold);
+    Summary reused = summarize(pooled);
+    std::println("{} queries of 2 requests each against {}", queries, base);
+    std::println("fresh client per query: median {:.3f} ms, mean {:.3f} ms", fresh.medianMs, fresh.meanMs);
+    std::println("pooled, first query:    {:.3f} ms", first);
+    std::println("pooled, later queries:  median {:.3f} ms, mean {:.3f} ms ({:.1f}x faster)", reused.medianMs,
+                 reused.meanMs, fresh.medianMs / reused.medianMs);
+    return 0;
+}
@@ -0,0 +1,194 @@
+/**
+ * SPDX-FileComment: Benchmark of the grid index against linear scans
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file grid_index.cpp
+ * @brief Measures circle, bounding box and nearest-neighbour queries on a
+ * GridIndex against linear scans over the same coordinate columns, for
+ * growing numbers of random POIs, and checks that both agree.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <print>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "GridIndex.hpp"
+#include "PoiStoreFormat.hpp"
+#include "RadiusFilter.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Queries per measurement; the linear scans of 1e7 points dominate the run time
+constexpr int kQueries = 20;
+
+// POIs and queries lie in a box around Germany, as a national extract would
+constexpr double kSouth = 47.3;
+constexpr double kWest = 5.9;
+constexpr double kNorth = 55.0;
+constexpr double kEast = 15.0;
+
+double microsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+void report(const std::string& query, double linearMicros, double indexMicros, double hits) {
+    std::println("  {:<16} linear {:>10.1f} us   index {:>8.2f} us   {:>7.0f}x   {:>8.1f} hits", query,
+                 linearMicros / kQueries, indexMicros / kQueries, linearMicros / indexMicros, hits / kQueries);
+}
+
+// Runs every query kind on @p count random POIs; returns the number of disagreements
+int run(std::size_t count, std::uint32_t cellsPerDegree) {
+    std::mt19937_64 rng(count);
+    std::uniform_real_distribution<double> lat(kSouth, kNorth);
+    std::uniform_real_distribution<double> lon(kWest, kEast);
+    std::vector<std::int32_t> lats(count);
+    std::vector<std::int32_t> lons(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        lats[i] = geo::quantize(lat(rng));
+        lons[i] = geo::quantize(lon(rng));
+    }
+
+    // The store keeps its columns in cell order, and so does the benchmark
+    auto start = Clock::now();
+    std::vector<std::size_t> order;
+    std::vector<grid::Cell> cells;
+    GridIndex::build(lats, lons, cellsPerDegree, order, cells);
+    std::vector<std::int32_t> sortedLats(count);
+    std::vector<std::int32_t> sortedLons(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        sortedLats[i] = lats[order[i]];
+        sortedLons[i] = lons[order[i]];
+    }
+    GridIndex index(sortedLats.data(), sortedLons.data(), count, cells.data(), cells.size(), cellsPerDegree);
+    std::println("{} POIs, {} cells of 1/{} degree, built in {:.0f} ms", count, cells.size(), cellsPerDegree,
+                 microsSince(start) / 1000.0);
+
+    // Queries stay clear of the edges, so every circle lies among the POIs
+    std::mt19937 queries(7);
+    std::uniform_real_distribution<double> queryLat(kSouth + 0.3, kNorth - 0.3);
+    std::uniform_real_distribution<double> queryLon(kWest + 0.3, kEast - 0.3);
+    std::vector<std::uint32_t> inside(count);
+    std::vector<double> distances(count);
+    int mismatches = 0;
+
+    // The linear scan runs the same vectorized filter over every point
+    for (double radius : {1000.0, 5000.0, 20000.0}) {
+        double linear = 0.0;
+        double indexed = 0.0;
+        std::size_t hits = 0;
+        for (int q = 0; q < kQueries; ++q) {
+            double centerLat = queryLat(queries);
+            double centerLon = queryLon(queries);
+            geo::RadiusFilter filter(centerLat, centerLon, radius);
+
+            auto t = Clock::now();
+            std::size_t expected =
+                filter.filter(sortedLats.data(), sortedLons.data(), count, inside.data(), distances.data());
+            linear += microsSince(t);
+
+            std::size_t found = 0;
+            t = Clock::now();
+            index.circle(centerLat, centerLon, radius, [&found](std::size_t, double) { ++found; });
+            indexed += microsSince(t);
+
+            hits += found;
+            if (found != expected) ++mismatches;
+        }
+        report(std::format("circle {:.0f} m", radius), linear, indexed, static_cast<double>(hits));
+    }
+
+    for (double side : {0.02, 0.2, 1.0}) {
+        double linear = 0.0;
+        double indexed = 0.0;
+        std::size_t hits = 0;
+        for (int q = 0; q < kQueries; ++q) {
+            double centerLat = queryLat(queries);
+            double centerLon = queryLon(queries);
+            tiles::BBox box{centerLat - side / 2, centerLon - side / 2, centerLat + side / 2, centerLon + side / 2};
+            std::int32_t south = geo::quantize(box.south);
+            std::int32_t west = geo::quantize(box.west);
+            std::int32_t north = geo::quantize(box.north);
+            std::int32_t east = geo::quantize(box.east);
+
+            auto t = Clock::now();
+            std::size_t expected = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                expected += sortedLats[i] >= south && sortedLats[i] <= north && sortedLons[i] >= west &&
+                            sortedLons[i] <= east;
+            }
+            linear += microsSince(t);
+
+            std::size_t found = 0;
+            t = Clock::now();
+            index.box(box, [&found](std::size_t) { ++found; });
+            indexed += microsSince(t);
+
+            hits += found;
+            if (found != expected) ++mismatches;
+        }
+        report(std::format("bbox {:.2f} deg", side), linear, indexed, static_cast<double>(hits));
+    }
+
+    // The linear nearest search measures every point and selects the k smallest
+    for (std::size_t k : {1, 10, 100}) {
+        if (k > count) break;
+        double linear = 0.0;
+        double indexed = 0.0;
+        for (int q = 0; q < kQueries; ++q) {
+            double centerLat = queryLat(queries);
+            double centerLon = queryLon(queries);
+            geo::RadiusFilter everywhere(centerLat, centerLon, 2.0e7);
+
+            auto t = Clock::now();
+            std::size_t measured =
+                everywhere.filter(sortedLats.data(), sortedLons.data(), count, inside.data(), distances.data());
+            auto kth = distances.begin() + static_cast<std::ptrdiff_t>(k - 1);
+            std::nth_element(distances.begin(), kth, distances.begin() + static_cast<std::ptrdiff_t>(measured));
+            linear += microsSince(t);
+
+            t = Clock::now();
+            auto nearest = index.nearest(centerLat, centerLon, k, 2.0e7, [](std::size_t, double) { return true; });
+            indexed += microsSince(t);
+
+            if (nearest.size() != k || nearest.back().distanceMeters != *kth) ++mismatches;
+        }
+        report(std::format("nearest k={}", k), linear, indexed, static_cast<double>(k * kQueries));
+    }
+    return mismatches;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::size_t> counts;
+    for (int i = 1; i < argc; ++i) counts.push_back(std::strtoull(argv[i], nullptr, 10));
+    if (counts.empty()) counts = {100'000, 1'000'000, 10'000'000};
+
+    std::println("kernel: {}", geo::RadiusFilter::kernelName(geo::RadiusFilter::bestKernel()));
+    int mismatches = 0;
+    for (std::size_t count : counts) {
+        if (count == 0) continue;
+        mismatches += run(count, poistore::kCellsPerDegree);
+    }
+    if (mismatches != 0) {
+        std::println(stderr, "{} queries disagreed with the linear scan", mismatches);
+        return 1;
+    }
+    return 0;
+}
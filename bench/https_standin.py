@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+# SPDX-FileComment: Local HTTPS stand-in for Nominatim and Overpass
+# SPDX-FileContributor: ZHENG Robert
+# SPDX-FileCopyrightText: 2026 ZHENG Robert
+# SPDX-License-Identifier: MIT
+#
+# Answers GET /search like Nominatim and POST /api/interpreter like Overpass
+# with fixed responses over HTTPS with keep-alive, so that the benchmarks
+# measure the client and not the servers. The Overpass response holds 20
+# elements by default; bench_allocations wants a realistic one, e.g. 1000.
+#
+# Usage:
+#   openssl req -x509 -newkey rsa:2048 -nodes -days 1 -subj /CN=localhost \
+#       -addext subjectAltName=DNS:localhost -keyout key.pem -out cert.pem
+#   python3 https_standin.py cert.pem key.pem [port] [elements]
+
+import json
+import ssl
+import sys
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+GEOCODE = json.dumps([{"lat": "48.1371", "lon": "11.5754"}]).encode()
+KINDS = [("tourism", "viewpoint"), ("tourism", "museum"), ("amenity", "restaurant"), ("amenity", "cafe"),
+         ("shop", "bakery")]
+
+
+def overpass_response(count):
+    """Nodes and, every seventh element, a way or relation placed by its center."""
+    elements = []
+    for i in range(count):
+        key, value = KINDS[i % len(KINDS)]
+        position = {"lat": 48.1371 + (i % 50) * 1e-4, "lon": 11.5754 - (i // 50) * 1e-4}
+        element = {"type": "node", "id": 1000 + i}
+        if i % 7 == 0:
+            element["type"] = "way" if i % 2 else "relation"
+            element["center"] = position
+        else:
+            element.update(position)
+        element["tags"] = {key: value, "name": f"{value.capitalize()} {i}"}
+        elements.append(element)
+    return json.dumps({"version": 0.6, "elements": elements}).encode()
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    disable_nagle_algorithm = True
+    overpass = b""
+
+    def log_message(self, *args):
+        pass
+
+    def reply(self, body, code=200):
+        self.send_response(code)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def do_GET(self):
+        if self.path.startswith("/search"):
+            self.reply(GEOCODE)
+        else:
+            self.reply(b"{}", 404)
+
+    def do_POST(self):
+        self.rfile.read(int(self.headers.get("Content-Length", 0)))
+        if self.path.startswith("/api/interpreter"):
+            self.reply(self.overpass)
+        else:
+            self.reply(b"{}", 404)
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit("usage: https_standin.py CERT KEY [PORT] [ELEMENTS]")
+    port = int(sys.argv[3]) if len(sys.argv) > 3 else 8443
+    Handler.overpass = overpass_response(int(sys.argv[4]) if len(sys.argv) > 4 else 20)
+    context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+    context.load_cert_chain(sys.argv[1], sys.argv[2])
+    server = ThreadingHTTPServer(("localhost", port), Handler)
+    server.socket = context.wrap_socket(server.socket, server_side=True)
+    print(f"listening on https://localhost:{port}", flush=True)
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
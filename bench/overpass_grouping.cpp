@@ -0,0 +1,184 @@
+/**
+ * SPDX-FileComment: Benchmark of grouped Overpass queries against one statement per whitelist entry
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file overpass_grouping.cpp
+ * @brief Sends the query the client builds for a whitelist of 7 entries over
+ * 3 keys, which evaluates the area once and filters it by key, and the same
+ * search written as one area statement per entry, to the evaluating stand-in
+ * bench/overpass_standin.py. Reports query and response bytes, server time
+ * and round trip time of both, and checks that they return the same elements.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <memory>
+#include <print>
+#include <set>
+#include <string>
+#include <vector>
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+
+#include "PoiOsm.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Response {
+    std::string body;
+    double serverMs = -1.0;
+};
+
+std::size_t appendBody(char* data, std::size_t size, std::size_t count, void* user) {
+    static_cast<Response*>(user)->body.append(data, size * count);
+    return size * count;
+}
+
+// Picks the duration out of the stand-in's "Server-Timing: eval;dur=12.345"
+std::size_t readTiming(char* data, std::size_t size, std::size_t count, void* user) {
+    std::string line(data, size * count);
+    std::string lower = line;
+    std::ranges::transform(lower, lower.begin(), [](unsigned char ch) { return std::tolower(ch); });
+    if (lower.starts_with("server-timing:")) {
+        if (auto at = lower.find("dur="); at != std::string::npos) {
+            static_cast<Response*>(user)->serverMs = std::strtod(line.c_str() + at + 4, nullptr);
+        }
+    }
+    return size * count;
+}
+
+// GET, or POST of @p query as Overpass form data; an empty body on failure
+Response request(CURL* curl, const std::string& url, const std::string& query = {}) {
+    Response response;
+    std::string post;
+    curl_easy_reset(curl);
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, appendBody);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, readTiming);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &response);
+    if (!query.empty()) {
+        std::unique_ptr<char, decltype(&curl_free)> escaped(
+            curl_easy_escape(curl, query.c_str(), static_cast<int>(query.size())), curl_free);
+        post = std::string("data=") + escaped.get();
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, post.c_str());
+    }
+    long status = 0;
+    if (curl_easy_perform(curl) != CURLE_OK ||
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status) != CURLE_OK || status != 200) {
+        response.body.clear();
+    }
+    return response;
+}
+
+struct Measurement {
+    std::size_t responseBytes = 0;
+    std::set<long long> ids;
+    double bestServerMs = 1e300;
+    double meanServerMs = 0.0;
+    double bestRoundTripMs = 1e300;
+};
+
+// Sends @p query @p rounds times; no ids on failure
+Measurement measure(CURL* curl, const std::string& url, const std::string& query, int rounds) {
+    Measurement m;
+    for (int r = 0; r < rounds; ++r) {
+        auto start = Clock::now();
+        Response response = request(curl, url, query);
+        double roundTrip = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (response.body.empty()) return {};
+        m.bestRoundTripMs = std::min(m.bestRoundTripMs, roundTrip);
+        m.bestServerMs = std::min(m.bestServerMs, response.serverMs);
+        m.meanServerMs += response.serverMs / rounds;
+        if (r == 0) {
+            m.responseBytes = response.body.size();
+            auto parsed = nlohmann::json::parse(response.body, nullptr, false);
+            if (parsed.is_discarded()) return {};
+            for (const auto& element : parsed["elements"]) m.ids.insert(element["id"].get<long long>());
+        }
+    }
+    return m;
+}
+
+void report(const std::string& form, std::size_t queryBytes, const Measurement& m) {
+    std::println("  {:<18} query {:>4} B   response {:>7} B   server best {:>6.1f} ms, mean {:>6.1f} ms   "
+                 "round trip best {:>6.1f} ms",
+                 form, queryBytes, m.responseBytes, m.bestServerMs, m.meanServerMs, m.bestRoundTripMs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::println(stderr, "usage: {} BASE_URL [ROUNDS]", argv[0]);
+        std::println(stderr, "  e.g. {} http://localhost:8780 20 (see overpass_standin.py)", argv[0]);
+        return 2;
+    }
+    std::string base = argv[1];
+    std::string interpreter = base + "/api/interpreter";
+    int rounds = argc > 2 ? std::max(1, std::atoi(argv[2])) : 10;
+
+    const double lat = 48.1371;
+    const double lon = 11.5754;
+    const int radius = 20000;
+    const std::vector<PoiWhitelistEntry> whitelist = {
+        {"tourism", "viewpoint"}, {"tourism", "museum"}, {"tourism", "hotel"}, {"amenity", "restaurant"},
+        {"amenity", "cafe"},      {"amenity", "pub"},    {"shop", "bakery"},
+    };
+
+    // The client's own query, read back from the stand-in
+    PoiOsmClientOptions options;
+    options.overpassEndpoint = interpreter;
+    options.resultCacheCapacity = 0;
+    PoiOsmClient client(options);
+    auto result = client.queryByCoordinates(lat, lon, radius, whitelist);
+    if (!result) {
+        std::println(stderr, "Query failed: {}", result.error());
+        return 1;
+    }
+
+    std::unique_ptr<CURL, decltype(&curl_easy_cleanup)> curl(curl_easy_init(), curl_easy_cleanup);
+    std::string grouped = request(curl.get(), base + "/last-query").body;
+    if (grouped.empty()) {
+        std::println(stderr, "Could not read the last query from {}", base);
+        return 1;
+    }
+
+    // The form sent before entries were grouped: every entry repeats the area
+    std::string area = std::format("(around:{},{:.6f},{:.6f})", radius, lat, lon);
+    std::string perEntry = "[out:json][timeout:25];(";
+    for (const auto& w : whitelist) perEntry += std::format("node{}[\"{}\"=\"{}\"];", area, w.key, w.value);
+    perEntry += ");out center;";
+
+    Measurement byKey = measure(curl.get(), interpreter, grouped, rounds);
+    Measurement byEntry = measure(curl.get(), interpreter, perEntry, rounds);
+    if (byKey.ids.empty() || byEntry.ids.empty()) {
+        std::println(stderr, "A query failed or returned no elements");
+        return 1;
+    }
+
+    std::println("{} entries over 3 keys, {} m around Munich, {} rounds against {}", whitelist.size(), radius,
+                 rounds, base);
+    report("grouped by key", grouped.size(), byKey);
+    report("one per entry", perEntry.size(), byEntry);
+    std::println("  {} elements; server time {:.1f}x lower when grouped", byKey.ids.size(),
+                 byEntry.bestServerMs / byKey.bestServerMs);
+    if (byKey.ids != byEntry.ids) {
+        std::println(stderr, "The two forms returned different elements");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,232 @@
+#!/usr/bin/env python3
+# SPDX-FileComment: Local Overpass stand-in that evaluates the queries it receives
+# SPDX-FileContributor: ZHENG Robert
+# SPDX-FileCopyrightText: 2026 ZHENG Robert
+# SPDX-License-Identifier: MIT
+#
+# Answers POST /api/interpreter over plain HTTP by evaluating the subset of
+# Overpass QL the client sends (node/nwr statements with around or bbox
+# areas, tag filters, named sets and unions, out [skel] center) against
+# synthetic POIs around Munich. Like Overpass, every area statement scans
+# the data on its own, while a statement on a named set only reads that
+# set. Each response carries its evaluation time in a Server-Timing header,
+# and GET /last-query returns the last query text received.
+#
+# Usage:
+#   python3 overpass_standin.py [port] [elements]
+
+import json
+import math
+import re
+import sys
+import time
+import urllib.parse
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+KINDS = [("tourism", "viewpoint"), ("tourism", "museum"), ("tourism", "hotel"), ("amenity", "restaurant"),
+         ("amenity", "cafe"), ("amenity", "pub"), ("amenity", "bench"), ("shop", "bakery"), ("shop", "kiosk"),
+         ("leisure", "park")]
+TOKEN = re.compile(r'\s*(\[out:\w+\]|\[timeout:\d+\]|"(?:[^"\\]|\\.)*"|->|[A-Za-z_]\w*|-?\d+(?:\.\d+)?|\S)')
+
+
+def synthetic_elements(count):
+    """Elements spread over about 110 km around Munich; every seventh one is a way or relation."""
+    elements = []
+    for i in range(count):
+        key, value = KINDS[i % len(KINDS)]
+        position = {"lat": 48.1371 + ((i * 7919) % 1000 - 500) * 1e-3,
+                    "lon": 11.5754 + ((i * 104729) % 1500 - 750) * 1e-3}
+        element = {"type": "node", "id": 1000 + i}
+        if i % 7 == 0:
+            element["type"] = "way" if i % 2 else "relation"
+            element["center"] = position
+        else:
+            element.update(position)
+        element["tags"] = {key: value, "name": f"{value.capitalize()} {i}"}
+        elements.append(element)
+    return elements
+
+
+def position(element):
+    center = element.get("center", element)
+    return center["lat"], center["lon"]
+
+
+def distance(lat1, lon1, lat2, lon2):
+    p1, p2 = math.radians(lat1), math.radians(lat2)
+    h = math.sin((p2 - p1) / 2) ** 2 + math.cos(p1) * math.cos(p2) * math.sin(math.radians(lon2 - lon1) / 2) ** 2
+    return 2 * 6371008.8 * math.asin(math.sqrt(h))
+
+
+def unquote(token):
+    return re.sub(r'\\(.)', r'\1', token[1:-1])
+
+
+class Query:
+    """Evaluates one query; raises ValueError on anything outside the supported subset."""
+
+    def __init__(self, text, elements):
+        self.tokens = [t for t in TOKEN.findall(text) if not t.startswith(("[out:", "[timeout:"))]
+        self.position = 0
+        self.elements = elements
+        self.sets = {"_": []}
+        self.output = None
+
+    def peek(self):
+        return self.tokens[self.position] if self.position < len(self.tokens) else ""
+
+    def take(self, expected=None):
+        token = self.peek()
+        if not token or (expected is not None and token != expected):
+            raise ValueError(f"expected {expected or 'more input'} at token {self.position}, got {token!r}")
+        self.position += 1
+        return token
+
+    def run(self):
+        while self.peek() == ";":
+            self.take()
+        while self.peek():
+            if self.peek() == "out":
+                self.out()
+            else:
+                self.sets["_"] = self.statement()
+        if self.output is None:
+            raise ValueError("no out statement")
+        return self.output
+
+    def statement(self):
+        """A union or a query, with an optional ->.name; returns its result."""
+        if self.peek() == "(":
+            self.take()
+            result = {}
+            while self.peek() != ")":
+                result.update((e["id"], e) for e in self.statement())
+            self.take(")")
+            result = list(result.values())
+        else:
+            result = self.query()
+        if self.peek() == "->":
+            self.take()
+            self.take(".")
+            self.sets[self.take()] = result
+        self.take(";")
+        return result
+
+    def query(self):
+        kind = self.take()
+        if kind not in ("node", "nwr"):
+            raise ValueError(f"unsupported statement {kind}")
+        if self.peek() == ".":
+            self.take()
+            candidates = self.sets.get(self.take(), [])
+        else:
+            candidates = self.elements
+        if kind == "node":
+            candidates = [e for e in candidates if e["type"] == "node"]
+        while self.peek() == "(":
+            candidates = self.area(candidates)
+        while self.peek() == "[":
+            candidates = self.tag_filter(candidates)
+        return candidates
+
+    def area(self, candidates):
+        self.take("(")
+        if self.peek() == "around":
+            self.take()
+            self.take(":")
+            radius = float(self.take())
+            self.take(",")
+            lat = float(self.take())
+            self.take(",")
+            lon = float(self.take())
+            self.take(")")
+            return [e for e in candidates if distance(lat, lon, *position(e)) <= radius]
+        south = float(self.take())
+        self.take(",")
+        west = float(self.take())
+        self.take(",")
+        north = float(self.take())
+        self.take(",")
+        east = float(self.take())
+        self.take(")")
+        return [e for e in candidates if south <= position(e)[0] <= north and west <= position(e)[1] <= east]
+
+    def tag_filter(self, candidates):
+        self.take("[")
+        key = unquote(self.take())
+        if self.peek() == "]":
+            self.take()
+            return [e for e in candidates if key in e["tags"]]
+        operator = self.take()
+        value = unquote(self.take())
+        self.take("]")
+        if operator == "=":
+            return [e for e in candidates if e["tags"].get(key) == value]
+        if operator == "~":
+            pattern = re.compile(value)
+            return [e for e in candidates if key in e["tags"] and pattern.search(e["tags"][key])]
+        raise ValueError(f"unsupported tag operator {operator}")
+
+    def out(self):
+        self.take("out")
+        modes = set()
+        while self.peek() != ";":
+            modes.add(self.take())
+        self.take(";")
+        if "count" in modes:
+            raise ValueError("out count is not supported")
+        elements = self.sets["_"]
+        if "skel" in modes:
+            elements = [{k: v for k, v in e.items() if k != "tags"} for e in elements]
+        self.output = elements
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    disable_nagle_algorithm = True
+    elements = []
+    last_query = ""
+
+    def log_message(self, *args):
+        pass
+
+    def reply(self, body, code=200, content_type="application/json", millis=None):
+        self.send_response(code)
+        self.send_header("Content-Type", content_type)
+        self.send_header("Content-Length", str(len(body)))
+        if millis is not None:
+            self.send_header("Server-Timing", f"eval;dur={millis:.3f}")
+        self.end_headers()
+        self.wfile.write(body)
+
+    def do_GET(self):
+        if self.path.startswith("/last-query"):
+            self.reply(Handler.last_query.encode(), content_type="text/plain")
+        else:
+            self.reply(b"{}", 404)
+
+    def do_POST(self):
+        body = self.rfile.read(int(self.headers.get("Content-Length", 0))).decode()
+        if not self.path.startswith("/api/interpreter"):
+            return self.reply(b"{}", 404)
+        text = urllib.parse.parse_qs(body).get("data", [""])[0]
+        Handler.last_query = text
+        start = time.perf_counter()
+        try:
+            elements = Query(text, self.elements).run()
+        except ValueError as error:
+            return self.reply(json.dumps({"remark": f"static error: {error}"}).encode(), 400)
+        response = json.dumps({"version": 0.6, "elements": elements}).encode()
+        self.reply(response, millis=(time.perf_counter() - start) * 1000)
+
+
+def main():
+    port = int(sys.argv[1]) if len(sys.argv) > 1 else 8780
+    Handler.elements = synthetic_elements(int(sys.argv[2]) if len(sys.argv) > 2 else 20000)
+    server = ThreadingHTTPServer(("localhost", port), Handler)
+    print(f"listening on http://localhost:{port}", flush=True)
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,135 @@
+/**
+ * SPDX-FileComment: Benchmark of the whitelist matcher against a linear scan
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file whitelist_matcher.cpp
+ * @brief Measures whitelist::Matcher against a linear scan of the whitelist
+ * entries for whitelists of 1, 10 and 100 entries, on random POIs with 2 to
+ * 7 tags, and checks that both accept the same POIs.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <print>
+#include <random>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "PoiOsm.hpp"
+#include "Whitelist.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Passes over all POIs per measurement
+constexpr int kRounds = 5;
+
+// Keys and values are drawn from pools of this size, so whitelists of up to
+// kKeys * kValues distinct entries can be built
+constexpr int kKeys = 40;
+constexpr int kValues = 25;
+
+double nanosSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+// The matching before the Matcher: every entry probes the POI's tags in turn
+bool linearMatches(const nlohmann::json& tags, const std::vector<PoiWhitelistEntry>& entries) {
+    if (entries.empty()) return true;
+    for (const auto& w : entries) {
+        auto it = tags.find(w.key);
+        if (it == tags.end()) continue;
+        if (w.value.empty() || (it->is_string() && it->get_ref<const std::string&>() == w.value)) return true;
+    }
+    return false;
+}
+
+std::string key(int i) {
+    return std::format("key{}", i);
+}
+
+std::string value(int i) {
+    return std::format("value{}", i);
+}
+
+// Random POIs with 2 to 7 distinct tags each
+std::vector<nlohmann::json> makePois(std::size_t count) {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> tagCount(2, 7);
+    std::uniform_int_distribution<int> keys(0, kKeys - 1);
+    std::uniform_int_distribution<int> values(0, kValues - 1);
+    std::vector<nlohmann::json> pois;
+    pois.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        nlohmann::json tags = nlohmann::json::object();
+        for (int n = tagCount(rng); static_cast<int>(tags.size()) < n;) tags[key(keys(rng))] = value(values(rng));
+        pois.push_back(std::move(tags));
+    }
+    return pois;
+}
+
+// @p count distinct entries; every fourth one accepts any value
+std::vector<PoiWhitelistEntry> makeWhitelist(std::size_t count) {
+    std::mt19937 rng(static_cast<unsigned>(count));
+    std::uniform_int_distribution<int> entry(0, kKeys * kValues - 1);
+    std::vector<PoiWhitelistEntry> whitelist;
+    while (whitelist.size() < count) {
+        int e = entry(rng);
+        PoiWhitelistEntry w{key(e / kValues), whitelist.size() % 4 == 3 ? std::string() : value(e % kValues)};
+        bool duplicate = false;
+        for (const auto& other : whitelist) duplicate = duplicate || (other.key == w.key && other.value == w.value);
+        if (!duplicate) whitelist.push_back(std::move(w));
+    }
+    return whitelist;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+    if (count == 0) count = 1;
+    auto pois = makePois(count);
+    std::println("{} POIs with 2 to 7 tags, {} passes", count, kRounds);
+
+    int mismatches = 0;
+    for (std::size_t entries : {1, 10, 100}) {
+        auto whitelist = makeWhitelist(entries);
+
+        // Compiling the whitelist is part of every query, so it is timed too
+        std::size_t linearAccepted = 0;
+        std::size_t matcherAccepted = 0;
+        auto t = Clock::now();
+        for (int r = 0; r < kRounds; ++r) {
+            for (const auto& tags : pois) linearAccepted += linearMatches(tags, whitelist);
+        }
+        double linear = nanosSince(t);
+        t = Clock::now();
+        for (int r = 0; r < kRounds; ++r) {
+            whitelist::Matcher matcher(whitelist);
+            for (const auto& tags : pois) matcherAccepted += matcher.matches(tags);
+        }
+        double matcher = nanosSince(t);
+
+        if (linearAccepted != matcherAccepted) ++mismatches;
+        double perPoi = static_cast<double>(count) * kRounds;
+        std::println("  {:>3} entries   linear {:>7.1f} ns   matcher {:>7.1f} ns   {:>5.1f}x   {:>5.1f}% accepted",
+                     entries, linear / perPoi, matcher / perPoi, linear / matcher,
+                     100.0 * static_cast<double>(matcherAccepted) / perPoi);
+    }
+    if (mismatches != 0) {
+        std::println(stderr, "{} whitelists were matched differently by the linear scan", mismatches);
+        return 1;
+    }
+    return 0;
+}
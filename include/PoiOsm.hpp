@@ -17,11 +17,32 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <expected>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <nlohmann/json.hpp>
 
+#include "PoiResult.hpp"
+#include "PoiTask.hpp"
+
+class AsyncEngine;
+class CurlPool;
+class GeocodeCache;
+class GeocodeStore;
+struct OsmElement;
+class PoiOsmReactor;
+class PoiStore;
+class SpatialCache;
+class TileCache;
+
 /**
  * @brief Represents a whitelist entry for filtering POIs.
  *
@@ -34,14 +55,157 @@ struct PoiWhitelistEntry {
     std::string value; ///< The tag value (optional).
 };
 
+/**
+ * @brief Order of the POIs in a result.
+ */
+enum class PoiSortOrder {
+    None,     ///< In the order of the source: Overpass, the tiles, the POI store's grid or the cache.
+    Distance, ///< Nearest to the query center first.
+};
+
+/**
+ * @brief Configuration of a PoiOsmClient.
+ *
+ * The endpoints can be pointed at a mirror or a local stand-in server.
+ */
+struct PoiOsmClientOptions {
+    std::string nominatimEndpoint = "https://nominatim.openstreetmap.org/search"; ///< Nominatim search URL.
+    std::string overpassEndpoint = "https://overpass-api.de/api/interpreter";     ///< Overpass interpreter URL.
+    std::size_t maxPooledHandles = 4; ///< Idle CURL handles kept open for reuse.
+    std::string caBundle;             ///< CA certificates file verifying the endpoints (empty = libcurl's default).
+    long maxConnectionsPerHost = 2;   ///< Concurrent async connections per host (0 = unlimited).
+    long maxTotalConnections = 0;     ///< Concurrent async connections overall (0 = unlimited).
+    std::size_t geocodeCacheCapacity = 1024;                  ///< Cached addresses (0 disables the cache).
+    std::chrono::seconds geocodeCacheTtl = std::chrono::hours(24);        ///< Lifetime of cached coordinates.
+    std::chrono::seconds geocodeNegativeCacheTtl = std::chrono::hours(1); ///< Lifetime of cached "no result" answers.
+    std::size_t resultCacheCapacity = 8;                          ///< Cached Overpass results (0 disables the cache).
+    std::chrono::seconds resultCacheTtl = std::chrono::minutes(10); ///< Lifetime of cached Overpass results.
+    bool tiledFetch = false;              ///< Fetch large radii as concurrent per-tile bbox queries.
+    int tileZoom = 10;                    ///< Web Mercator zoom level of the fetch tiles.
+    std::size_t tileCacheCapacity = 256;  ///< Cached tiles (0 disables the cache); they live for resultCacheTtl.
+    bool adaptiveSplit = false;           ///< Retry areas failing with timeout, memory or busy errors as quadrants.
+    int maxSplitDepth = 4;                ///< Maximum quadrant split levels per area (4 = up to 256 pieces).
+    bool includeWaysAndRelations = false; ///< Query nodes, ways and relations (nwr); areas are placed at their center.
+    std::size_t limit = 0;                ///< Return at most this many POIs (0 = all); limited results are not cached.
+    PoiSortOrder sort = PoiSortOrder::None; ///< With a limit and Distance, the nearest POIs are kept.
+    std::size_t tileThreshold = 0;        ///< Without tiledFetch, count first and fetch tiled above this many elements (0 = never).
+    std::optional<std::vector<std::string>> tags; ///< Tags kept per POI besides the whitelist keys (unset = all; empty = none).
+};
+
+/**
+ * @brief Counters of a client-side cache.
+ */
+struct PoiCacheStats {
+    std::uint64_t hits = 0;        ///< Lookups answered from the cache.
+    std::uint64_t misses = 0;      ///< Lookups that had to go to the network.
+    std::uint64_t evictions = 0;   ///< Entries dropped to respect the size limit.
+    std::uint64_t expirations = 0; ///< Entries dropped because their TTL elapsed.
+    std::size_t entries = 0;       ///< Entries currently held.
+    std::uint64_t bytesSaved = 0;  ///< Estimated response bytes not downloaded thanks to hits.
+
+    /// Share of lookups answered from the cache, 0 if there were none.
+    double hitRatio() const {
+        return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+    }
+};
+
+/**
+ * @brief Settings of PoiOsmClient::buildPoiStore().
+ */
+struct PoiImportOptions {
+    /// Decoding threads; 0 uses one per hardware thread.
+    unsigned threads = 0;
+
+    /// Elements are imported if they carry one of these tag keys; empty
+    /// imports every tagged element. Queries whose whitelist uses other keys
+    /// are not answered from the store.
+    std::vector<std::string> keys = {"amenity", "shop", "tourism", "leisure", "historic", "craft",
+                                     "office", "healthcare", "emergency", "sport", "club"};
+
+    /// Import ways and relations, placed at the center of their bounding box.
+    bool waysAndRelations = true;
+
+    /// Memory for buffered POI records, the node ids of ways and relations
+    /// and resolved node positions; more is spilled to disk or resolved in
+    /// further passes over the file. Way and relation records wait on disk.
+    /// Not covered: the tag string dictionary, a 48-byte bounding box per way
+    /// and relation, and about 60 bytes per distinct member way of a relation.
+    std::size_t memoryBudget = std::size_t{512} << 20;
+};
+
+/**
+ * @brief Outcome of PoiOsmClient::buildPoiStore().
+ */
+struct PoiImportStats {
+    std::uint64_t poiNodes = 0;     ///< Nodes written to the store.
+    std::uint64_t poiWays = 0;      ///< Ways written to the store.
+    std::uint64_t poiRelations = 0; ///< Relations written to the store.
+    std::uint64_t unresolved = 0;   ///< Ways and relations dropped because none of their nodes is in the extract.
+    std::uint64_t nodes = 0;        ///< Nodes in the extract.
+    std::uint64_t ways = 0;         ///< Ways in the extract.
+    std::uint64_t relations = 0;    ///< Relations in the extract.
+    std::uint64_t blobs = 0;        ///< Blobs in the extract.
+    std::uint64_t blobReads = 0;    ///< Blobs decoded over all passes.
+    unsigned passes = 0;            ///< Passes over the extract.
+    unsigned threads = 0;           ///< Decoding threads used.
+    std::size_t spilledRuns = 0;    ///< Sorted runs written to disk because the buffer was full.
+    double seconds = 0.0;           ///< Wall time of the import.
+
+    /// POIs written.
+    std::uint64_t pois() const { return poiNodes + poiWays + poiRelations; }
+
+    /// Blobs decoded per second, over all passes.
+    double blobsPerSecond() const { return seconds > 0.0 ? static_cast<double>(blobReads) / seconds : 0.0; }
+
+    /// Nodes of the extract imported per second.
+    double nodesPerSecond() const { return seconds > 0.0 ? static_cast<double>(nodes) / seconds : 0.0; }
+};
+
+/// Result of a POI query: the result JSON or an error message.
+using PoiQueryResult = std::expected<nlohmann::json, std::string>;
+
+/// Completion callback of the asynchronous query API.
+using PoiQueryCallback = std::function<void(PoiQueryResult)>;
+
+/// Receives the POIs of a streamed query, one object as in `results.pois` per call.
+using PoiSink = std::function<void(const nlohmann::json&)>;
+
 /**
  * @brief Client for querying Points of Interest (POIs) from OpenStreetMap.
  *
  * This class provides methods to query POIs either by address (using Nominatim
  * for geocoding) or by direct geographic coordinates (using Overpass API).
+ *
+ * The client owns a pool of CURL handles that keep their connections open and
+ * share DNS and TLS session caches, so keeping one client alive across queries
+ * avoids a new DNS lookup, TCP connect and TLS handshake per request.
+ *
+ * The *Async methods run on a curl_multi event loop owned by the client, so
+ * many geocode and Overpass requests can be in flight at once. The client must
+ * outlive (and must not be moved during) its pending asynchronous queries.
+ *
+ * The *Task methods return co_await-able coroutines driven by a
+ * PoiOsmReactor, which lets a single thread chain geocoding, Overpass and
+ * post-processing for many concurrent queries.
  */
 class PoiOsmClient {
 public:
+    /**
+     * @brief Creates a client with default options.
+     */
+    PoiOsmClient();
+
+    /**
+     * @brief Creates a client with custom options.
+     *
+     * @param options Endpoints and connection pool settings.
+     */
+    explicit PoiOsmClient(PoiOsmClientOptions options);
+
+    ~PoiOsmClient();
+    PoiOsmClient(PoiOsmClient&&) noexcept;
+    PoiOsmClient& operator=(PoiOsmClient&&) noexcept;
+
     /**
      * @brief Queries POIs around a specific address.
      *
@@ -72,7 +236,367 @@ public:
         double lat, double lon, int radiusMeters,
         const std::vector<PoiWhitelistEntry>& whitelist = {});
 
+    /**
+     * @brief Streaming variant of queryByAddress().
+     *
+     * See streamByCoordinates().
+     *
+     * @param address The address to search for.
+     * @param radiusMeters The search radius in meters.
+     * @param whitelist List of key-value pairs to filter results.
+     * @param sink Receives each POI.
+     * @return std::expected<nlohmann::json, std::string> The result JSON without `results.pois`, or an error message.
+     */
+    std::expected<nlohmann::json, std::string> streamByAddress(
+        const std::string& address, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist,
+        const PoiSink& sink);
+
+    /**
+     * @brief Streaming variant of queryByCoordinates().
+     *
+     * Each POI is passed to @p sink as soon as it has been parsed from the
+     * Overpass response, and none of them is kept, so memory use does not
+     * grow with the result. Streamed results are not added to the result
+     * cache. With tiledFetch or adaptiveSplit the pieces are merged first and
+     * the POIs are delivered afterwards. If an error is returned, some POIs
+     * may already have been delivered.
+     *
+     * @param lat Latitude of the center point.
+     * @param lon Longitude of the center point.
+     * @param radiusMeters The search radius in meters.
+     * @param whitelist List of key-value pairs to filter results.
+     * @param sink Receives each POI.
+     * @return std::expected<nlohmann::json, std::string> The result JSON without `results.pois`
+     * (`results.count` holds the number of POIs delivered), or an error message.
+     */
+    std::expected<nlohmann::json, std::string> streamByCoordinates(
+        double lat, double lon, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist,
+        const PoiSink& sink);
+
+    /**
+     * @brief Typed variant of queryByAddress().
+     *
+     * See queryByCoordinatesTyped().
+     *
+     * @param address The address to search for.
+     * @param radiusMeters The search radius in meters.
+     * @param whitelist List of key-value pairs to filter results.
+     * @return std::expected<PoiResult, std::string> The POIs or an error message.
+     */
+    std::expected<PoiResult, std::string> queryByAddressTyped(
+        const std::string& address, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist = {});
+
+    /**
+     * @brief Typed variant of queryByCoordinates().
+     *
+     * The Overpass response is parsed straight into a PoiResult without
+     * building any JSON; call PoiResult::toJson() for the document
+     * queryByCoordinates() would have returned. Like streamed results, typed
+     * results are not added to the result cache, but a cached result is used
+     * if there is one.
+     *
+     * @param lat Latitude of the center point.
+     * @param lon Longitude of the center point.
+     * @param radiusMeters The search radius in meters.
+     * @param whitelist List of key-value pairs to filter results.
+     * @return std::expected<PoiResult, std::string> The POIs or an error message.
+     */
+    std::expected<PoiResult, std::string> queryByCoordinatesTyped(
+        double lat, double lon, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist = {});
+
+    /**
+     * @brief Counts the POIs around an address without downloading them.
+     *
+     * See queryCountByCoordinates().
+     *
+     * @param address The address to search for.
+     * @param radiusMeters The search radius in meters.
+     * @param whitelist List of key-value pairs to filter results.
+     * @return std::expected<nlohmann::json, std::string> The result JSON or an error message.
+     */
+    std::expected<nlohmann::json, std::string> queryCountByAddress(
+        const std::string& address, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist = {});
+
+    /**
+     * @brief Counts the POIs around a point without downloading them.
+     *
+     * Overpass counts the elements itself (`out count`), so the response is
+     * a few hundred bytes whatever the area holds. `results.count` is the
+     * number of elements matching any whitelist entry and `results.counts`
+     * the number matching each entry. Counts follow Overpass's `around`
+     * semantics: a way or relation counts if any part of it lies inside the
+     * circle, while a POI query measures from its center. The result has no
+     * `pois` and is not cached.
+     *
+     * @param lat Latitude of the center point.
+     * @param lon Longitude of the center point.
+     * @param radiusMeters The search radius in meters.
+     * @param whitelist List of key-value pairs to filter results.
+     * @return std::expected<nlohmann::json, std::string> The result JSON or an error message.
+     */
+    std::expected<nlohmann::json, std::string> queryCountByCoordinates(
+        double lat, double lon, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist = {});
+
+    /**
+     * @brief Finds the POIs nearest to an address.
+     *
+     * See queryNearestByCoordinates().
+     *
+     * @param address The address to search for.
+     * @param count Number of POIs wanted.
+     * @param whitelist List of key-value pairs to filter results.
+     * @param maxRadiusMeters The search never extends beyond this radius.
+     * @return std::expected<nlohmann::json, std::string> The result JSON or an error message.
+     */
+    std::expected<nlohmann::json, std::string> queryNearestByAddress(
+        const std::string& address, std::size_t count,
+        const std::vector<PoiWhitelistEntry>& whitelist = {},
+        int maxRadiusMeters = 100000);
+
+    /**
+     * @brief Finds the POIs nearest to a point.
+     *
+     * Searches a 1 km circle first and widens it fourfold per round (4 km,
+     * 16 km, ...) until it holds @p count POIs or reaches
+     * @p maxRadiusMeters. POIs outside the searched circle are farther away
+     * than all inside it, so the @p count nearest found are the true
+     * nearest. Ways and relations count by their center, like their
+     * `distance_m`, so one matched by a circle with its center outside
+     * waits for a wider round. After a round fetched from Overpass, the
+     * next one only fetches the ring around it and adds the POIs found
+     * before. Rounds that are tiled (tiledFetch, or tileThreshold exceeded)
+     * reuse the cached tiles of earlier ones instead, and rounds the result
+     * cache holds are not fetched at all; adaptive splitting applies to
+     * rings and tiles. A client limit only caps the answer, which is always
+     * nearest first. `query.nearest.bytes_per_round` lists the Overpass
+     * response bytes of each round. When the POI store covers the whole
+     * @p maxRadiusMeters circle, its spatial index finds the nearest POIs
+     * directly, in a single round. A @p count of 0 gives an empty result.
+     *
+     * @param lat Latitude of the center point.
+     * @param lon Longitude of the center point.
+     * @param count Number of POIs wanted.
+     * @param whitelist List of key-value pairs to filter results.
+     * @param maxRadiusMeters The search never extends beyond this radius.
+     * @return std::expected<nlohmann::json, std::string> The result JSON with at most @p count POIs,
+     * nearest first, and a `query.nearest` report, or an error message.
+     */
+    std::expected<nlohmann::json, std::string> queryNearestByCoordinates(
+        double lat, double lon, std::size_t count,
+        const std::vector<PoiWhitelistEntry>& whitelist = {},
+        int maxRadiusMeters = 100000);
+
+    /**
+     * @brief Asynchronous variant of queryByAddress().
+     *
+     * @param address The address to search for.
+     * @param radiusMeters The search radius in meters.
+     * @param whitelist List of key-value pairs to filter results.
+     * @return std::future<PoiQueryResult> Becomes ready with the result JSON or an error message.
+     */
+    std::future<PoiQueryResult> queryByAddressAsync(
+        const std::string& address, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist = {});
+
+    /**
+     * @brief Asynchronous variant of queryByAddress() with a completion callback.
+     *
+     * @param address The address to search for.
+     * @param radiusMeters The search radius in meters.
+     * @param whitelist List of key-value pairs to filter results.
+     * @param done Invoked on the client's event loop thread with the result. Blocking queries made from
+     * it cannot wait for that thread; their tiles and split areas are fetched on a private reactor.
+     */
+    void queryByAddressAsync(
+        const std::string& address, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist,
+        PoiQueryCallback done);
+
+    /**
+     * @brief Asynchronous variant of queryByCoordinates().
+     *
+     * @param lat Latitude of the center point.
+     * @param lon Longitude of the center point.
+     * @param radiusMeters The search radius in meters.
+     * @param whitelist List of key-value pairs to filter results.
+     * @return std::future<PoiQueryResult> Becomes ready with the result JSON or an error message.
+     */
+    std::future<PoiQueryResult> queryByCoordinatesAsync(
+        double lat, double lon, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist = {});
+
+    /**
+     * @brief Asynchronous variant of queryByCoordinates() with a completion callback.
+     *
+     * @param lat Latitude of the center point.
+     * @param lon Longitude of the center point.
+     * @param radiusMeters The search radius in meters.
+     * @param whitelist List of key-value pairs to filter results.
+     * @param done Invoked on the client's event loop thread with the result. Blocking queries made from
+     * it cannot wait for that thread; their tiles and split areas are fetched on a private reactor.
+     */
+    void queryByCoordinatesAsync(
+        double lat, double lon, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist,
+        PoiQueryCallback done);
+
+    /**
+     * @brief Coroutine variant of queryByAddress().
+     *
+     * The geocoding and Overpass requests are awaited on @p reactor instead of
+     * blocking the calling thread. Tiling, adaptive splitting and the tile
+     * threshold apply as in queryByAddress(); the count, tile and quadrant
+     * requests run concurrently on @p reactor too.
+     *
+     * @param reactor The reactor driving the transfers.
+     * @param address The address to search for.
+     * @param radiusMeters The search radius in meters.
+     * @param whitelist List of key-value pairs to filter results.
+     * @return PoiTask<PoiQueryResult> Task producing the result JSON or an error message.
+     */
+    PoiTask<PoiQueryResult> queryByAddressTask(
+        PoiOsmReactor& reactor, std::string address, int radiusMeters,
+        std::vector<PoiWhitelistEntry> whitelist = {});
+
+    /**
+     * @brief Coroutine variant of queryByCoordinates().
+     *
+     * Tiles and split areas are fetched on @p reactor, as in queryByAddressTask().
+     *
+     * @param reactor The reactor driving the transfers.
+     * @param lat Latitude of the center point.
+     * @param lon Longitude of the center point.
+     * @param radiusMeters The search radius in meters.
+     * @param whitelist List of key-value pairs to filter results.
+     * @return PoiTask<PoiQueryResult> Task producing the result JSON or an error message.
+     */
+    PoiTask<PoiQueryResult> queryByCoordinatesTask(
+        PoiOsmReactor& reactor, double lat, double lon, int radiusMeters,
+        std::vector<PoiWhitelistEntry> whitelist = {});
+
+    /**
+     * @brief Returns the counters of the in-memory geocoding cache.
+     *
+     * Addresses are cached under a normalized key (trimmed, whitespace
+     * collapsed, ASCII lower-cased), including negative "no result" answers.
+     *
+     * @return PoiCacheStats Snapshot of hits, misses and size.
+     */
+    PoiCacheStats geocodeCacheStats() const;
+
+    /**
+     * @brief Opens a persistent geocoding cache shared across processes.
+     *
+     * The store (a memory-mapped append-only log at @p path plus a hash index
+     * at `<path>.idx`) is consulted after the in-memory cache and before any
+     * Nominatim request; new results are appended to it. Several processes may
+     * read the store while one of them writes. Call it before issuing
+     * queries. Not available on Windows.
+     *
+     * @param path Path of the store's log file; created if missing.
+     * @return std::expected<void, std::string> Empty on success, or an error message.
+     */
+    std::expected<void, std::string> openGeocodeStore(const std::string& path);
+
+    /**
+     * @brief Opens an offline POI store built by buildPoiStore().
+     *
+     * Queries whose circle lies inside the store's extract are then answered
+     * from the store, without any Overpass request; all others, queries
+     * that need ways and relations the store lacks and queries for tag keys
+     * the import skipped still go to Overpass. The results carry
+     * `source.poi_store`. The store is memory-mapped and queried in place,
+     * so opening is cheap even for country-sized stores. Call it before
+     * issuing queries.
+     *
+     * @param path Path of the store.
+     * @return std::expected<void, std::string> Empty on success, or an error message.
+     */
+    std::expected<void, std::string> openPoiStore(const std::string& path);
+
+    /**
+     * @brief Builds an offline POI store from an OpenStreetMap extract.
+     *
+     * Reads the POI elements of a `.osm.pbf` file (zlib or uncompressed
+     * blobs) into a compact file for openPoiStore(). Blobs are inflated and
+     * decoded on a thread pool. Ways and relations are placed at the center
+     * of their bounding box, which takes further passes over the file to
+     * look up the positions of their nodes.
+     *
+     * @param pbfPath Path of the `.osm.pbf` extract.
+     * @param storePath Path of the store to write; an existing store is replaced.
+     * @param options Threads, imported keys and memory budget.
+     * @return std::expected<PoiImportStats, std::string> Counts and timing, or an error message.
+     */
+    static std::expected<PoiImportStats, std::string> buildPoiStore(const std::string& pbfPath,
+                                                                    const std::string& storePath,
+                                                                    const PoiImportOptions& options = {});
+
+    /**
+     * @brief Returns the counters of the spatial Overpass result cache.
+     *
+     * A query is answered locally, without a network call, when its circle
+     * lies inside a cached query's circle and the cached whitelist accepts
+     * everything the new one accepts (e.g. `tourism` covers
+     * `tourism=viewpoint`). bytesSaved estimates the avoided download as the
+     * cached response size scaled by the share of cached POIs served.
+     *
+     * @return PoiCacheStats Snapshot of hits, misses, hit ratio and bytes saved.
+     */
+    PoiCacheStats resultCacheStats() const;
+
+    /**
+     * @brief Returns the counters of the per-tile Overpass cache.
+     *
+     * Only used when PoiOsmClientOptions::tiledFetch is set. Tiles are keyed
+     * by quadkey and whitelist, so queries around nearby centers share the
+     * tiles they overlap.
+     *
+     * @return PoiCacheStats Snapshot of hits, misses and size.
+     */
+    PoiCacheStats tileCacheStats() const;
+
 private:
+    /// Limit and order applied to the POIs of a query; see PoiSelector.
+    struct Selection {
+        std::size_t limit;
+        PoiSortOrder sort;
+    };
+
+    /// The selection configured by the client options.
+    Selection selection_() const { return {options_.limit, options_.sort}; }
+
+    /**
+     * @brief Runs requests to completion for a blocking method.
+     *
+     * They run on the client's event loop, or on a private reactor when the
+     * caller is an asynchronous completion running on that loop.
+     *
+     * @param start Sends the requests on the given reactor (nullptr for the
+     * event loop) and invokes its second argument once they are done.
+     */
+    void runBlocking_(const std::function<void(PoiOsmReactor*, std::function<void()>)>& start);
+
+    /// Sends an Overpass POST with the contract of AsyncEngine::submit(): the
+    /// body goes to the sink, if set, and the completion gets the outcome.
+    using OverpassSubmit = std::function<void(std::string postData,
+                                              std::function<void(std::expected<std::string, std::string>)> done,
+                                              std::function<bool(std::string_view)> sink)>;
+
+    /**
+     * @brief Returns how the requests of tiles and split areas are sent.
+     *
+     * @param reactor The reactor of a coroutine query, or nullptr for the client's event loop.
+     * @return OverpassSubmit Sends one request; completions run on the thread driving it.
+     */
+    OverpassSubmit overpassSubmit_(PoiOsmReactor* reactor);
+
     /**
      * @brief Internal helper to geocode an address.
      *
@@ -81,6 +605,39 @@ private:
      */
     std::expected<std::pair<double, double>, std::string> geocodeAddress_(const std::string& address);
 
+    /**
+     * @brief Builds the Nominatim search URL for an address.
+     *
+     * @param address The address to geocode.
+     * @return std::string The request URL.
+     */
+    std::string geocodeUrl_(const std::string& address);
+
+    /**
+     * @brief Extracts the coordinates from a Nominatim response body.
+     *
+     * @param response The raw response body.
+     * @return std::expected<std::pair<double, double>, std::string> The coordinates (lat, lon) or error.
+     */
+    std::expected<std::pair<double, double>, std::string> parseGeocodeResponse_(const std::string& response) const;
+
+    /**
+     * @brief Looks up an address in the in-memory cache, then in the persistent store.
+     *
+     * @param address The address to geocode.
+     * @return std::optional<...> The cached coordinates or "no result" error; std::nullopt on a miss.
+     */
+    std::optional<std::expected<std::pair<double, double>, std::string>> cachedGeocode_(const std::string& address);
+
+    /**
+     * @brief Records a geocoding result in the caches, if it is cacheable.
+     *
+     * @param address The geocoded address.
+     * @param coords The coordinates or error returned for it.
+     */
+    void rememberGeocode_(const std::string& address,
+                          const std::expected<std::pair<double, double>, std::string>& coords);
+
     /**
      * @brief Internal helper to perform the Overpass API query.
      *
@@ -89,13 +646,288 @@ private:
      * @param radiusMeters Search radius.
      * @param whitelist Filter list.
      * @param queryInput The original query input (for result JSON construction).
+     * @param selection Limit and order of the POIs.
      * @return std::expected<nlohmann::json, std::string> The result JSON or error.
      */
     std::expected<nlohmann::json, std::string> queryOverpass_(
         double lat, double lon, int radiusMeters,
         const std::vector<PoiWhitelistEntry>& whitelist,
+        const nlohmann::json& queryInput,
+        Selection selection);
+
+    /**
+     * @brief Streaming variant of queryOverpass_().
+     *
+     * @param lat Latitude.
+     * @param lon Longitude.
+     * @param radiusMeters Search radius.
+     * @param whitelist Filter list.
+     * @param queryInput The original query input (for result JSON construction).
+     * @param sink Receives each POI.
+     * @return std::expected<nlohmann::json, std::string> The result JSON without POIs, or error.
+     */
+    std::expected<nlohmann::json, std::string> streamOverpass_(
+        double lat, double lon, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist,
+        const nlohmann::json& queryInput,
+        const PoiSink& sink);
+
+    /**
+     * @brief Store or expanding-radius search behind queryNearestByCoordinates().
+     *
+     * @param lat Latitude.
+     * @param lon Longitude.
+     * @param count Number of POIs wanted.
+     * @param maxRadiusMeters Largest search radius.
+     * @param whitelist Filter list.
+     * @param queryInput The original query input (for result JSON construction).
+     * @return std::expected<nlohmann::json, std::string> The result JSON or error.
+     */
+    std::expected<nlohmann::json, std::string> queryNearest_(
+        double lat, double lon, std::size_t count, int maxRadiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist,
         const nlohmann::json& queryInput);
 
+    /**
+     * @brief Typed variant of queryOverpass_().
+     *
+     * @param lat Latitude.
+     * @param lon Longitude.
+     * @param radiusMeters Search radius.
+     * @param whitelist Filter list.
+     * @param queryInput The original query input (for result JSON construction).
+     * @return std::expected<PoiResult, std::string> The POIs or error.
+     */
+    std::expected<PoiResult, std::string> queryOverpassTyped_(
+        double lat, double lon, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist,
+        const nlohmann::json& queryInput);
+
+    /**
+     * @brief Sets `distance_m` on cached POIs and applies limit and sort to them.
+     *
+     * @param pois POIs in result JSON layout.
+     * @param distances Distance of each POI from the query center, as measured by the cache.
+     * @param selection Limit and order of the POIs.
+     * @return nlohmann::json The chosen POIs.
+     */
+    nlohmann::json selectPois_(nlohmann::json pois, const std::vector<double>& distances, Selection selection) const;
+
+    /**
+     * @brief Asynchronous variant of queryOverpass_().
+     *
+     * @param lat Latitude.
+     * @param lon Longitude.
+     * @param radiusMeters Search radius.
+     * @param whitelist Filter list.
+     * @param queryInput The original query input (for result JSON construction).
+     * @param done Invoked with the result JSON or error.
+     */
+    void queryOverpassAsync_(
+        double lat, double lon, int radiusMeters,
+        std::vector<PoiWhitelistEntry> whitelist,
+        nlohmann::json queryInput,
+        PoiQueryCallback done);
+
+    /**
+     * @brief queryOverpassAsync_() after a result cache miss.
+     *
+     * @param lat Latitude.
+     * @param lon Longitude.
+     * @param radiusMeters Search radius.
+     * @param whitelist Filter list.
+     * @param queryInput The original query input (for result JSON construction).
+     * @param tiled Whether to fetch the circle as tiles.
+     * @param selection Limit and order of the POIs.
+     * @param reactor Reactor driving the transfers, or nullptr for the client's event loop.
+     * @param done Invoked with the result JSON or error.
+     */
+    void fetchOverpassAsync_(
+        double lat, double lon, int radiusMeters,
+        std::vector<PoiWhitelistEntry> whitelist,
+        nlohmann::json queryInput,
+        bool tiled,
+        Selection selection,
+        PoiOsmReactor* reactor,
+        PoiQueryCallback done);
+
+    /**
+     * @brief Counts the elements of a circle with an `out count` query.
+     *
+     * @param lat Latitude.
+     * @param lon Longitude.
+     * @param radiusMeters Search radius.
+     * @param whitelist Filter list.
+     * @return std::expected<std::vector<std::size_t>, std::string> The number of elements matching
+     * any entry, followed by the number matching each distinct entry, or an error.
+     */
+    std::expected<std::vector<std::size_t>, std::string> countOverpass_(
+        double lat, double lon, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist);
+
+    /**
+     * @brief Builds the count result JSON behind queryCountByCoordinates().
+     *
+     * @param lat Latitude.
+     * @param lon Longitude.
+     * @param radiusMeters Search radius.
+     * @param whitelist Filter list.
+     * @param queryInput The original query input (for result JSON construction).
+     * @return std::expected<nlohmann::json, std::string> The result JSON or error.
+     */
+    std::expected<nlohmann::json, std::string> queryCount_(
+        double lat, double lon, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist,
+        const nlohmann::json& queryInput);
+
+    /**
+     * @brief Coroutine variant of queryOverpass_().
+     *
+     * @param reactor The reactor driving the transfers.
+     * @param lat Latitude.
+     * @param lon Longitude.
+     * @param radiusMeters Search radius.
+     * @param whitelist Filter list.
+     * @param queryInput The original query input (for result JSON construction).
+     * @return PoiTask<PoiQueryResult> Task producing the result JSON or error.
+     */
+    PoiTask<PoiQueryResult> queryOverpassTask_(
+        PoiOsmReactor& reactor,
+        double lat, double lon, int radiusMeters,
+        std::vector<PoiWhitelistEntry> whitelist,
+        nlohmann::json queryInput);
+
+    /**
+     * @brief Fetches a circle as the set of tiles covering it.
+     *
+     * Missing tiles are requested concurrently as bbox queries, split into
+     * quadrants on failure if adaptiveSplit is set; cached tiles are reused.
+     * The merged elements are deduplicated by OSM type and id and filtered to
+     * the circle.
+     *
+     * @param lat Latitude.
+     * @param lon Longitude.
+     * @param radiusMeters Search radius.
+     * @param whitelist Filter list.
+     * @param queryInput The original query input (for result JSON construction).
+     * @param selection Limit and order of the POIs.
+     * @param reactor Reactor driving the transfers, or nullptr for the client's event loop.
+     * @param done Invoked with the result JSON or the first tile error.
+     */
+    void queryTilesAsync_(
+        double lat, double lon, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist,
+        const nlohmann::json& queryInput,
+        Selection selection,
+        PoiOsmReactor* reactor,
+        PoiQueryCallback done);
+
+    /**
+     * @brief Answers a query from the spatial result cache, if possible.
+     *
+     * @param lat Latitude.
+     * @param lon Longitude.
+     * @param radiusMeters Search radius.
+     * @param whitelist Filter list.
+     * @param queryInput The original query input (for result JSON construction).
+     * @param selection Limit and order of the POIs.
+     * @return std::optional<nlohmann::json> The result JSON, or std::nullopt on a miss.
+     */
+    std::optional<nlohmann::json> cachedResult_(
+        double lat, double lon, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist,
+        const nlohmann::json& queryInput,
+        Selection selection) const;
+
+    /**
+     * @brief Checks whether the POI store can answer a query.
+     *
+     * @param lat Latitude.
+     * @param lon Longitude.
+     * @param radiusMeters Search radius.
+     * @param whitelist Filter list.
+     * @return bool true if a store is open, holds the requested element
+     * types and keys and covers the circle.
+     */
+    bool storeCovers_(double lat, double lon, int radiusMeters,
+                      const std::vector<PoiWhitelistEntry>& whitelist) const;
+
+    /**
+     * @brief Hands the POIs of a circle from the POI store to a sink.
+     *
+     * @param lat Latitude.
+     * @param lon Longitude.
+     * @param radiusMeters Search radius.
+     * @param whitelist Filter list.
+     * @param sink Receiver of the projected elements.
+     * @return std::size_t Bytes of tags the projection dropped.
+     */
+    std::size_t queryStore_(double lat, double lon, int radiusMeters,
+                            const std::vector<PoiWhitelistEntry>& whitelist,
+                            const std::function<void(const OsmElement&)>& sink) const;
+
+    /**
+     * @brief Answers a query from the POI store.
+     *
+     * @param lat Latitude.
+     * @param lon Longitude.
+     * @param radiusMeters Search radius.
+     * @param whitelist Filter list.
+     * @param queryInput The original query input (for result JSON construction).
+     * @param selection Limit and order of the POIs.
+     * @return nlohmann::json The result JSON.
+     */
+    nlohmann::json storeResult_(
+        double lat, double lon, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist,
+        const nlohmann::json& queryInput,
+        Selection selection) const;
+
+    /**
+     * @brief Counts the POIs of a circle in the POI store, like countOverpass_().
+     *
+     * @param lat Latitude.
+     * @param lon Longitude.
+     * @param radiusMeters Search radius.
+     * @param whitelist Filter list.
+     * @param entries The distinct entries of @p whitelist.
+     * @return std::expected<std::vector<std::size_t>, std::string> The number of POIs matching
+     * any entry, followed by the number matching each entry.
+     */
+    std::expected<std::vector<std::size_t>, std::string> storeCounts_(
+        double lat, double lon, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist,
+        const std::vector<PoiWhitelistEntry>& entries) const;
+
+    /**
+     * @brief Builds the form body of an Overpass request.
+     *
+     * @param query The Overpass QL query.
+     * @return std::string The URL-encoded POST body.
+     */
+    std::string overpassPostData_(const std::string& query);
+
+    /**
+     * @brief Builds the result JSON from parsed Overpass elements and stores it in the spatial cache.
+     *
+     * @param elements The whitelisted Overpass elements.
+     * @param responseBytes Size of the Overpass response(s) the elements came from.
+     * @param tagBytesDropped Bytes of tags the projection dropped from the response(s).
+     * @param lat Latitude.
+     * @param lon Longitude.
+     * @param radiusMeters Search radius.
+     * @param whitelist Filter list.
+     * @param queryInput The original query input (for result JSON construction).
+     * @param selection Limit and order of the POIs; only unlimited results are cached.
+     * @return nlohmann::json The result JSON.
+     */
+    nlohmann::json overpassResult_(
+        const nlohmann::json& elements, std::size_t responseBytes, std::size_t tagBytesDropped,
+        double lat, double lon, int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist,
+        const nlohmann::json& queryInput,
+        Selection selection) const;
+
     /**
      * @brief Builds the Overpass QL query string.
      *
@@ -109,6 +941,33 @@ private:
         double lat, double lon, int radiusMeters,
         const std::vector<PoiWhitelistEntry>& whitelist) const;
 
+    /**
+     * @brief Builds an Overpass QL query for an arbitrary area filter.
+     *
+     * @param area The node filters, e.g. "(around:500,48.1,11.5)", "(s,w,n,e)" or both.
+     * @param whitelist Filter list.
+     * @param exclude If set, an area filter whose matches are left out, e.g. the circle of an earlier round.
+     * @return std::string The formatted Overpass QL query.
+     */
+    std::string buildOverpassAreaQuery_(
+        const std::string& area,
+        const std::vector<PoiWhitelistEntry>& whitelist,
+        const std::string& exclude = {}) const;
+
+    /**
+     * @brief Builds an Overpass QL query counting the elements of an area.
+     *
+     * The first `out count` covers all entries together. With several
+     * distinct entries, one `out count` per entry follows.
+     *
+     * @param area The node filters, e.g. "(around:500,48.1,11.5)".
+     * @param whitelist Filter list.
+     * @return std::string The formatted Overpass QL query.
+     */
+    std::string buildOverpassCountQuery_(
+        const std::string& area,
+        const std::vector<PoiWhitelistEntry>& whitelist) const;
+
     /**
      * @brief Constructs the final JSON result object.
      *
@@ -118,6 +977,7 @@ private:
      * @param whitelist Filter list used.
      * @param elements The raw elements array from Overpass.
      * @param queryInput The input parameters.
+     * @param selection Limit and order of the POIs.
      * @return nlohmann::json The structured result JSON.
      */
     nlohmann::json buildResultJson_(
@@ -125,5 +985,35 @@ private:
         int radiusMeters,
         const std::vector<PoiWhitelistEntry>& whitelist,
         const nlohmann::json& elements,
-        const nlohmann::json& queryInput) const;
+        const nlohmann::json& queryInput,
+        Selection selection) const;
+
+    /**
+     * @brief Wraps a POIs array into the result JSON (source, query and results blocks).
+     *
+     * @param centerLat Latitude of the search center.
+     * @param centerLon Longitude of the search center.
+     * @param radiusMeters Search radius.
+     * @param whitelist Filter list used.
+     * @param pois The POIs array.
+     * @param queryInput The input parameters.
+     * @param duplicatesDropped Elements dropped because they were received more than once.
+     * @return nlohmann::json The structured result JSON.
+     */
+    nlohmann::json wrapResultJson_(
+        double centerLat, double centerLon,
+        int radiusMeters,
+        const std::vector<PoiWhitelistEntry>& whitelist,
+        nlohmann::json pois,
+        const nlohmann::json& queryInput,
+        std::size_t duplicatesDropped = 0) const;
+
+    PoiOsmClientOptions options_;
+    std::unique_ptr<GeocodeCache> geocodeCache_;
+    std::unique_ptr<GeocodeStore> geocodeStore_;
+    std::unique_ptr<PoiStore> poiStore_;
+    std::unique_ptr<SpatialCache> resultCache_;
+    std::unique_ptr<TileCache> tileCache_;
+    std::unique_ptr<CurlPool> pool_;
+    std::unique_ptr<AsyncEngine> engine_;
 };
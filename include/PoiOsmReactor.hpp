@@ -0,0 +1,159 @@
+/**
+ * SPDX-FileComment: Header file for the single-threaded coroutine reactor
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file PoiOsmReactor.hpp
+ * @brief Defines the PoiOsmReactor class that drives the coroutine API of
+ * PoiOsmClient over libcurl's socket callbacks.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "PoiTask.hpp"
+
+class CurlPool;
+class PoiOsmClient;
+
+/**
+ * @brief Single-threaded event loop for PoiTask based POI queries.
+ *
+ * The reactor owns a curl_multi handle in socket-action mode: libcurl reports
+ * the sockets and timeouts it is interested in, the reactor polls them and
+ * resumes the coroutines whose transfers finished. All tasks spawned on one
+ * reactor, and the reactor itself, must be used from a single thread.
+ *
+ * @code
+ * PoiOsmReactor reactor;
+ * PoiOsmClient client;
+ * auto result = reactor.run(client.queryByAddressTask(reactor, "Marienplatz, Munich", 1000));
+ * @endcode
+ */
+class PoiOsmReactor {
+public:
+    /**
+     * @brief Creates a reactor.
+     *
+     * @param maxConnectionsPerHost Concurrent connections per host, 0 for unlimited.
+     */
+    explicit PoiOsmReactor(long maxConnectionsPerHost = 2);
+
+    /**
+     * @brief Aborts unfinished transfers; tasks still waiting on them are never resumed.
+     */
+    ~PoiOsmReactor();
+
+    PoiOsmReactor(const PoiOsmReactor&) = delete;
+    PoiOsmReactor& operator=(const PoiOsmReactor&) = delete;
+
+    /**
+     * @brief Starts a task that runs to completion on this reactor.
+     *
+     * The task is owned by the reactor until it finishes. An exception leaving
+     * a spawned task terminates the program.
+     *
+     * @param task The task to start.
+     */
+    void spawn(PoiTask<void> task) { detach_(std::move(task)); }
+
+    /**
+     * @brief Runs the event loop until @p task has finished and returns its result.
+     *
+     * Other spawned tasks make progress while waiting.
+     *
+     * @tparam T The task's result type.
+     * @param task The task to run.
+     * @return T The task's result.
+     * @throws std::logic_error If the task waits on something other than this reactor.
+     */
+    template <typename T>
+    T run(PoiTask<T> task);
+
+    /**
+     * @brief Runs the event loop until no transfer is in flight.
+     */
+    void run();
+
+private:
+    friend class PoiOsmClient;
+    class FetchAwaiter;
+
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() const noexcept { return {}; }
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept {}
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+    };
+
+    static Detached detach_(PoiTask<void> task) { co_await std::move(task); }
+
+    /**
+     * @brief Creates an awaitable HTTP GET, or POST if @p postData is not empty.
+     *
+     * @param pool Pool providing the easy handle.
+     * @param url The request URL.
+     * @param postData Form body for POST requests.
+     * @param sink If set, receives the response body chunk by chunk and the
+     * awaiting coroutine gets an empty body.
+     * @return FetchAwaiter Resumes the awaiting coroutine with the body or an error message.
+     */
+    FetchAwaiter fetch_(CurlPool& pool, std::string url, std::string postData = {},
+                        std::function<bool(std::string_view)> sink = {});
+
+    /**
+     * @brief Waits for socket activity or the next timeout once and resumes finished transfers.
+     *
+     * @return bool false if no transfer was in flight.
+     */
+    bool runOnce_();
+
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+template <typename T>
+T PoiOsmReactor::run(PoiTask<T> task) {
+    using Slot = std::conditional_t<std::is_void_v<T>, bool, std::optional<T>>;
+    Slot result{};
+    std::exception_ptr error;
+    bool done = false;
+
+    spawn([](PoiTask<T> inner, Slot& out, std::exception_ptr& err, bool& finished) -> PoiTask<void> {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await std::move(inner);
+            } else {
+                out.emplace(co_await std::move(inner));
+            }
+        } catch (...) {
+            err = std::current_exception();
+        }
+        finished = true;
+    }(std::move(task), result, error, done));
+
+    while (!done && runOnce_()) {}
+
+    if (!done) throw std::logic_error("PoiTask suspended on something other than its PoiOsmReactor");
+    if (error) std::rethrow_exception(error);
+    if constexpr (!std::is_void_v<T>) return std::move(*result);
+}
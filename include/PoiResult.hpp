@@ -0,0 +1,142 @@
+/**
+ * SPDX-FileComment: Header file for the typed POI result
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file PoiResult.hpp
+ * @brief Defines Poi and PoiResult, the typed alternative to the result JSON
+ * of PoiOsmClient.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+/**
+ * @brief Location of a string in a PoiResult's string arena.
+ */
+struct PoiString {
+    std::uint32_t offset = 0;
+    std::uint32_t length = 0;
+};
+
+/**
+ * @brief One tag of a POI.
+ */
+struct PoiTag {
+    PoiString key;
+    PoiString value;
+};
+
+/**
+ * @brief OSM element type a POI was taken from.
+ */
+enum class PoiElementType : std::uint8_t {
+    Node,
+    Way,      ///< Placed at the way's center.
+    Relation, ///< Placed at the relation's center.
+};
+
+/**
+ * @brief Returns the OSM name of an element type ("node", "way", "relation").
+ */
+std::string_view toString(PoiElementType type);
+
+/**
+ * @brief One POI of a PoiResult.
+ *
+ * Strings are not stored in the POI itself; resolve them through the
+ * PoiResult it belongs to.
+ */
+struct Poi {
+    std::uint64_t id = 0;       ///< OSM id, unique per element type.
+    double lat = 0.0;
+    double lon = 0.0;
+    double distance = 0.0;      ///< Meters from the query center.
+    PoiString name;             ///< Value of the "name" tag; empty if there is none.
+    std::uint32_t firstTag = 0; ///< Index of the first tag in PoiResult::tags().
+    std::uint32_t tagCount = 0;
+    PoiElementType type = PoiElementType::Node;
+};
+
+/**
+ * @brief Typed result of a POI query.
+ *
+ * POIs are stored contiguously. Their tags are one flat array, and all
+ * strings live in a single arena in which every distinct string (tag keys
+ * such as "amenity", frequent values, names) is stored once. Building a
+ * result therefore costs a handful of allocations instead of several per
+ * POI. JSON is only produced when toJson() is called.
+ */
+class PoiResult {
+public:
+    /**
+     * @brief The POIs of the result.
+     *
+     * With PoiSortOrder::Distance they come nearest first. Otherwise they
+     * keep the order of their source: as Overpass returned them, tile by
+     * tile with tiled fetching, in the store's Hilbert cell order when a POI
+     * store answered (POIs close together come together, but not by
+     * distance), or in the order of the cached result a query was answered from.
+     */
+    const std::vector<Poi>& pois() const { return pois_; }
+
+    /// Elements dropped because they were received more than once.
+    std::size_t duplicatesDropped() const { return duplicatesDropped_; }
+
+    /// All tags; each POI refers to the range [firstTag, firstTag + tagCount).
+    const std::vector<PoiTag>& tagTable() const { return tags_; }
+
+    /// Resolves a string of this result.
+    std::string_view str(PoiString s) const { return std::string_view(arena_).substr(s.offset, s.length); }
+
+    /// Name of a POI, empty if it has none.
+    std::string_view name(const Poi& poi) const { return str(poi.name); }
+
+    /// Tags of a POI.
+    std::span<const PoiTag> tags(const Poi& poi) const {
+        return std::span<const PoiTag>(tags_).subspan(poi.firstTag, poi.tagCount);
+    }
+
+    /**
+     * @brief Looks up one tag of a POI.
+     *
+     * @param poi A POI of this result.
+     * @param key The tag key.
+     * @return std::optional<std::string_view> The value, or std::nullopt if the POI lacks the tag.
+     */
+    std::optional<std::string_view> tag(const Poi& poi, std::string_view key) const;
+
+    /**
+     * @brief Returns one POI in the layout of the result JSON's `results.pois`.
+     */
+    nlohmann::json poiJson(const Poi& poi) const;
+
+    /**
+     * @brief Returns the complete result document, identical to the JSON API.
+     */
+    nlohmann::json toJson() const;
+
+private:
+    friend class PoiResultBuilder;
+
+    std::vector<Poi> pois_;
+    std::vector<PoiTag> tags_;
+    std::string arena_;
+    std::size_t duplicatesDropped_ = 0;
+    nlohmann::json envelope_; // result document without results
+};
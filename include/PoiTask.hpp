@@ -0,0 +1,154 @@
+/**
+ * SPDX-FileComment: Header file for the POI query coroutine task type
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file PoiTask.hpp
+ * @brief Defines PoiTask, the lazily started, awaitable coroutine type
+ * returned by the coroutine API of PoiOsmClient.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+template <typename T>
+class PoiTask;
+
+namespace poi_task_detail {
+
+/**
+ * @brief Resumes the awaiting coroutine when a task finishes.
+ */
+struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+        if (auto continuation = handle.promise().continuation) return continuation;
+        return std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+/**
+ * @brief State shared by the promise types of all PoiTask specializations.
+ */
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+};
+
+} // namespace poi_task_detail
+
+/**
+ * @brief Lazily started coroutine producing a value of type T.
+ *
+ * The task starts running when it is first co_awaited and resumes its
+ * awaiter once it finishes. Top-level tasks are driven by
+ * PoiOsmReactor::run() or PoiOsmReactor::spawn().
+ *
+ * @tparam T The result type.
+ */
+template <typename T>
+class PoiTask {
+public:
+    struct promise_type : poi_task_detail::PromiseBase {
+        std::optional<T> value;
+
+        PoiTask get_return_object() {
+            return PoiTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        template <typename U>
+        void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+    };
+
+    PoiTask(PoiTask&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    PoiTask(const PoiTask&) = delete;
+    PoiTask& operator=(const PoiTask&) = delete;
+    PoiTask& operator=(PoiTask&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    ~PoiTask() { if (handle_) handle_.destroy(); }
+
+    bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept {
+        handle_.promise().continuation = awaiter;
+        return handle_;
+    }
+
+    T await_resume() {
+        auto& promise = handle_.promise();
+        if (promise.error) std::rethrow_exception(promise.error);
+        return std::move(*promise.value);
+    }
+
+private:
+    explicit PoiTask(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * @brief Lazily started coroutine without a result.
+ */
+template <>
+class PoiTask<void> {
+public:
+    struct promise_type : poi_task_detail::PromiseBase {
+        PoiTask get_return_object() {
+            return PoiTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        void return_void() noexcept {}
+    };
+
+    PoiTask(PoiTask&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    PoiTask(const PoiTask&) = delete;
+    PoiTask& operator=(const PoiTask&) = delete;
+    PoiTask& operator=(PoiTask&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    ~PoiTask() { if (handle_) handle_.destroy(); }
+
+    bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept {
+        handle_.promise().continuation = awaiter;
+        return handle_;
+    }
+
+    void await_resume() {
+        if (handle_.promise().error) std::rethrow_exception(handle_.promise().error);
+    }
+
+private:
+    explicit PoiTask(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
@@ -0,0 +1,207 @@
+/**
+ * SPDX-FileComment: Implementation of the curl_multi request engine
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file AsyncEngine.cpp
+ * @brief  Implements the AsyncEngine event loop on curl_multi_poll.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "AsyncEngine.hpp"
+
+#include <iterator>
+#include <utility>
+
+namespace {
+
+constexpr int kPollTimeoutMs = 1000;
+constexpr const char* kShutdownError = "Async engine shut down before the request completed";
+
+// Scheme, host and port of a URL, the unit of the per-host cap
+std::string hostOf(const std::string& url) {
+    auto start = url.find("://");
+    start = start == std::string::npos ? 0 : start + 3;
+    return url.substr(0, url.find_first_of("/?#", start));
+}
+
+} // namespace
+
+AsyncEngine::AsyncEngine(CurlPool& pool, long maxConnectionsPerHost, long maxTotalConnections)
+    : pool_(pool),
+      multi_(curl_multi_init()),
+      maxConnectionsPerHost_(maxConnectionsPerHost),
+      maxTotalConnections_(maxTotalConnections) {
+    if (multi_) {
+        curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, maxConnectionsPerHost);
+        curl_multi_setopt(multi_, CURLMOPT_MAX_TOTAL_CONNECTIONS, maxTotalConnections);
+    }
+}
+
+AsyncEngine::~AsyncEngine() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    if (multi_) curl_multi_wakeup(multi_);
+    if (worker_.joinable()) worker_.join();
+
+    // Requests queued after the worker's last drain never started
+    std::deque<std::unique_ptr<Transfer>> pending;
+    {
+        std::lock_guard lock(mutex_);
+        pending.swap(queue_);
+    }
+    for (auto& transfer : pending) {
+        auto done = std::move(transfer->done);
+        transfer.reset();
+        done(std::unexpected(kShutdownError));
+    }
+
+    if (multi_) curl_multi_cleanup(multi_);
+}
+
+void AsyncEngine::submit(std::string url, std::string postData, Completion done, CurlPool::ChunkSink sink) {
+    if (!multi_) {
+        done(std::unexpected("Failed to initialize CURL multi handle"));
+        return;
+    }
+
+    std::string host = hostOf(url);
+    auto transfer = std::make_unique<Transfer>(Transfer{
+        std::nullopt, std::move(host), std::move(url), std::move(postData), {}, std::move(done), std::move(sink)});
+
+    {
+        std::unique_lock lock(mutex_);
+        if (stopping_) {
+            lock.unlock();
+            auto callback = std::move(transfer->done);
+            transfer.reset();
+            callback(std::unexpected(kShutdownError));
+            return;
+        }
+        queue_.push_back(std::move(transfer));
+        if (!worker_.joinable()) worker_ = std::thread(&AsyncEngine::run_, this);
+    }
+    curl_multi_wakeup(multi_);
+}
+
+void AsyncEngine::run_() {
+    workerId_ = std::this_thread::get_id();
+    for (;;) {
+        std::deque<std::unique_ptr<Transfer>> incoming;
+        {
+            std::lock_guard lock(mutex_);
+            if (stopping_) break;
+            incoming.swap(queue_);
+        }
+        for (auto& transfer : incoming) waiting_.push_back(std::move(transfer));
+        startWaiting_();
+
+        int running = 0;
+        curl_multi_perform(multi_, &running);
+
+        int pending = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi_, &pending)) {
+            if (msg->msg == CURLMSG_DONE) finish_(msg->easy_handle, msg->data.result);
+        }
+
+        // Transfers started in freed slots are driven right away
+        if (startWaiting_()) continue;
+        curl_multi_poll(multi_, nullptr, 0, kPollTimeoutMs, nullptr);
+    }
+
+    // Abort whatever is still in flight or waiting
+    for (auto& [easy, transfer] : active_) {
+        curl_multi_remove_handle(multi_, easy);
+        auto done = std::move(transfer->done);
+        transfer.reset();
+        done(std::unexpected(kShutdownError));
+    }
+    active_.clear();
+    activePerHost_.clear();
+    for (auto& transfer : waiting_) {
+        auto done = std::move(transfer->done);
+        transfer.reset();
+        done(std::unexpected(kShutdownError));
+    }
+    waiting_.clear();
+}
+
+bool AsyncEngine::startWaiting_() {
+    // Waiting transfers keep their order; one whose host is at its cap does not hold up other hosts
+    bool started = false;
+    std::deque<std::unique_ptr<Transfer>> blocked;
+    while (!waiting_.empty()) {
+        if (maxTotalConnections_ > 0 && std::cmp_greater_equal(active_.size(), maxTotalConnections_)) break;
+
+        auto transfer = std::move(waiting_.front());
+        waiting_.pop_front();
+        if (maxConnectionsPerHost_ > 0 && activePerHost_[transfer->host] >= maxConnectionsPerHost_) {
+            blocked.push_back(std::move(transfer));
+            continue;
+        }
+        start_(std::move(transfer));
+        started = true;
+    }
+    blocked.insert(blocked.end(), std::make_move_iterator(waiting_.begin()), std::make_move_iterator(waiting_.end()));
+    waiting_.swap(blocked);
+    return started;
+}
+
+void AsyncEngine::start_(std::unique_ptr<Transfer> transfer) {
+    CURL* easy = transfer->handle.emplace(pool_.acquire()).get();
+    if (!easy) {
+        auto done = std::move(transfer->done);
+        transfer.reset();
+        done(std::unexpected("Failed to initialize CURL"));
+        return;
+    }
+
+    curl_easy_setopt(easy, CURLOPT_URL, transfer->url.c_str());
+    if (transfer->sink) {
+        curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, &CurlPool::writeToSink);
+        curl_easy_setopt(easy, CURLOPT_WRITEDATA, &transfer->sink);
+    } else {
+        curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, &CurlPool::appendToString);
+        curl_easy_setopt(easy, CURLOPT_WRITEDATA, &transfer->body);
+    }
+    if (!transfer->postData.empty()) {
+        curl_easy_setopt(easy, CURLOPT_POSTFIELDS, transfer->postData.c_str());
+    }
+
+    if (curl_multi_add_handle(multi_, easy) != CURLM_OK) {
+        auto done = std::move(transfer->done);
+        transfer.reset();
+        done(std::unexpected("Failed to add request to CURL multi handle"));
+        return;
+    }
+    ++activePerHost_[transfer->host];
+    active_.emplace(easy, std::move(transfer));
+}
+
+void AsyncEngine::finish_(CURL* easy, CURLcode result) {
+    auto it = active_.find(easy);
+    if (it == active_.end()) return;
+
+    auto transfer = std::move(it->second);
+    active_.erase(it);
+    if (--activePerHost_[transfer->host] == 0) activePerHost_.erase(transfer->host);
+    curl_multi_remove_handle(multi_, easy);
+
+    std::expected<std::string, std::string> response = std::move(transfer->body);
+    if (auto status = CurlPool::checkResult(easy, result); !status) {
+        response = std::unexpected(status.error());
+    }
+
+    // Hand the easy handle back before user code runs
+    auto done = std::move(transfer->done);
+    transfer.reset();
+    done(std::move(response));
+}
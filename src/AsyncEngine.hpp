@@ -0,0 +1,120 @@
+/**
+ * SPDX-FileComment: Internal header for the curl_multi request engine
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file AsyncEngine.hpp
+ * @brief Defines the AsyncEngine class that runs many HTTP requests in flight
+ * on a single curl_multi event loop.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <curl/curl.h>
+
+#include "CurlPool.hpp"
+
+/**
+ * @brief Event loop over curl_multi running on a dedicated worker thread.
+ *
+ * Requests are queued by submit() from any thread and picked up by the
+ * worker, which drives all transfers with curl_multi_poll(). A request
+ * waits in the worker's queue until the connection caps let it run; only
+ * then is an easy handle borrowed from the CurlPool, so a large batch does
+ * not hold a handle per waiting request. The handles share the pool's DNS
+ * and TLS session caches with the blocking API. Completions run on the
+ * worker thread and may submit follow-up requests.
+ */
+class AsyncEngine {
+public:
+    /// Receives the response body or an error message.
+    using Completion = std::function<void(std::expected<std::string, std::string>)>;
+
+    /**
+     * @brief Creates an idle engine; the worker thread starts on first submit().
+     *
+     * @param pool Pool providing the easy handles.
+     * @param maxConnectionsPerHost Concurrent connections per host, 0 for unlimited.
+     * @param maxTotalConnections Concurrent connections overall, 0 for unlimited.
+     */
+    AsyncEngine(CurlPool& pool, long maxConnectionsPerHost, long maxTotalConnections);
+
+    /**
+     * @brief Stops the worker; unfinished requests complete with an error.
+     */
+    ~AsyncEngine();
+
+    AsyncEngine(const AsyncEngine&) = delete;
+    AsyncEngine& operator=(const AsyncEngine&) = delete;
+
+    /**
+     * @brief Queues an HTTP GET, or POST if @p postData is not empty.
+     *
+     * Requests above the connection caps wait, without an easy handle,
+     * until a transfer to that host (or any transfer) finishes.
+     *
+     * @param url The request URL.
+     * @param postData Form body for POST requests.
+     * @param done Invoked on the worker thread with the result.
+     * @param sink If set, receives the response body chunk by chunk on the
+     * worker thread, and @p done gets an empty body.
+     */
+    void submit(std::string url, std::string postData, Completion done, CurlPool::ChunkSink sink = {});
+
+    /**
+     * @brief Whether the caller runs on the worker thread, i.e. inside a completion or sink.
+     *
+     * A caller there must not wait for other requests of this engine: they
+     * only progress once it returns.
+     */
+    bool onWorkerThread() const { return std::this_thread::get_id() == workerId_.load(); }
+
+private:
+    struct Transfer {
+        std::optional<CurlPool::Lease> handle; // borrowed when the transfer starts
+        std::string host;
+        std::string url;
+        std::string postData;
+        std::string body;
+        Completion done;
+        CurlPool::ChunkSink sink;
+    };
+
+    void run_();
+    bool startWaiting_();
+    void start_(std::unique_ptr<Transfer> transfer);
+    void finish_(CURL* easy, CURLcode result);
+
+    CurlPool& pool_;
+    CURLM* multi_;
+    long maxConnectionsPerHost_;
+    long maxTotalConnections_;
+
+    std::mutex mutex_;
+    std::deque<std::unique_ptr<Transfer>> queue_;
+    bool stopping_ = false;
+    std::thread worker_;
+    std::atomic<std::thread::id> workerId_;
+
+    // Owned by the worker thread only
+    std::deque<std::unique_ptr<Transfer>> waiting_;
+    std::unordered_map<CURL*, std::unique_ptr<Transfer>> active_;
+    std::unordered_map<std::string, long> activePerHost_;
+};
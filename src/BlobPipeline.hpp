@@ -0,0 +1,162 @@
+/**
+ * SPDX-FileComment: Internal header for parallel PBF blob decoding
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file BlobPipeline.hpp
+ * @brief Defines BlobPipeline, which decodes PBF blobs on a pool of threads
+ * and hands the results on in file order.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Pbf.hpp"
+
+/**
+ * @brief Decodes blobs in parallel and consumes the results in order.
+ *
+ * The caller reads blobs and submit()s them; worker threads inflate and
+ * decode them with @c decode, which must be thread-safe. The results are
+ * handed to @c consume one at a time and in submission order, on whichever
+ * worker completes the next one, so @c consume needs no locking of its own
+ * and its effects do not depend on the thread count. At most @c capacity
+ * blobs are queued, decoding or waiting to be consumed, which bounds the
+ * memory in flight; submit() blocks while the pipeline is full.
+ *
+ * @tparam Result What decoding one blob produces.
+ */
+template <typename Result>
+class BlobPipeline {
+public:
+    using Decode = std::function<std::expected<Result, std::string>(const pbf::RawBlob&)>;
+    using Consume = std::function<std::expected<void, std::string>(Result)>;
+
+    /**
+     * @brief Starts the workers.
+     *
+     * @param threads Number of decoding threads (at least one).
+     * @param decode Turns a blob into a result; called concurrently.
+     * @param consume Receives the results in order; called serially.
+     */
+    BlobPipeline(unsigned threads, Decode decode, Consume consume)
+        : decode_(std::move(decode)), consume_(std::move(consume)), capacity_(std::max(threads, 1u) * 4) {
+        for (unsigned i = 0; i < std::max(threads, 1u); ++i) workers_.emplace_back([this] { work_(); });
+    }
+
+    ~BlobPipeline() { (void)finish(); }
+
+    BlobPipeline(const BlobPipeline&) = delete;
+    BlobPipeline& operator=(const BlobPipeline&) = delete;
+
+    /**
+     * @brief Queues a blob, waiting while the pipeline is full.
+     *
+     * @return bool false once decoding or consuming has failed; reading can stop.
+     */
+    bool submit(pbf::RawBlob blob) {
+        std::unique_lock lock(mutex_);
+        spaceFree_.wait(lock, [this] { return inFlight_ < capacity_ || !error_.empty(); });
+        if (!error_.empty()) return false;
+
+        queue_.emplace_back(submitted_++, std::move(blob));
+        ++inFlight_;
+        workReady_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Waits until every submitted blob has been consumed and stops the workers.
+     *
+     * @return std::expected<void, std::string> Empty on success, or the first error.
+     */
+    std::expected<void, std::string> finish() {
+        {
+            std::lock_guard lock(mutex_);
+            closing_ = true;
+        }
+        workReady_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) worker.join();
+        }
+        if (!error_.empty()) return std::unexpected(error_);
+        return {};
+    }
+
+private:
+    void work_() {
+        std::unique_lock lock(mutex_);
+        while (true) {
+            workReady_.wait(lock, [this] { return !queue_.empty() || closing_; });
+            if (queue_.empty()) return;
+
+            auto [sequence, blob] = std::move(queue_.front());
+            queue_.pop_front();
+            bool failed = !error_.empty();
+            lock.unlock();
+            // After a failure the remaining blobs are only drained
+            std::expected<Result, std::string> result = std::unexpected(std::string());
+            if (!failed) result = decode_(blob);
+            lock.lock();
+
+            done_.emplace(sequence, std::move(result));
+            if (consuming_) continue;
+
+            // Whoever finds the next result in line consumes everything that is ready
+            consuming_ = true;
+            for (auto next = done_.find(consumed_); next != done_.end(); next = done_.find(consumed_)) {
+                auto ready = std::move(next->second);
+                done_.erase(next);
+                failed = !error_.empty();
+                lock.unlock();
+                std::expected<void, std::string> status;
+                if (!ready) status = std::unexpected(ready.error());
+                else if (!failed) status = consume_(std::move(*ready));
+                lock.lock();
+
+                if (!status && error_.empty()) error_ = status.error();
+                ++consumed_;
+                --inFlight_;
+                spaceFree_.notify_all();
+            }
+            consuming_ = false;
+        }
+    }
+
+    Decode decode_;
+    Consume consume_;
+    std::size_t capacity_;
+
+    std::mutex mutex_;
+    std::condition_variable workReady_;
+    std::condition_variable spaceFree_;
+    std::deque<std::pair<std::uint64_t, pbf::RawBlob>> queue_;
+    std::map<std::uint64_t, std::expected<Result, std::string>> done_;
+    std::uint64_t submitted_ = 0;
+    std::uint64_t consumed_ = 0;
+    std::size_t inFlight_ = 0;
+    bool consuming_ = false;
+    bool closing_ = false;
+    std::string error_;
+    std::vector<std::thread> workers_;
+};
@@ -0,0 +1,163 @@
+/**
+ * SPDX-FileComment: Implementation of the pooled libcurl transport
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file CurlPool.cpp
+ * @brief  Implements the CurlPool class on top of curl easy and share handles.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "CurlPool.hpp"
+
+#include <format>
+#include <utility>
+
+CurlPool::CurlPool(std::size_t maxIdleHandles, std::string caBundle)
+    : share_(curl_share_init()), maxIdleHandles_(maxIdleHandles), caBundle_(std::move(caBundle)) {
+    if (share_) {
+        curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &CurlPool::lock_);
+        curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &CurlPool::unlock_);
+        curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        // Not CURL_LOCK_DATA_CONNECT: libcurl does not support one connection
+        // cache for transfers running on several threads at once
+    }
+}
+
+CurlPool::~CurlPool() {
+    // Easy handles must be gone before the share can be released
+    for (CURL* curl : idle_) curl_easy_cleanup(curl);
+    idle_.clear();
+    if (share_) curl_share_cleanup(share_);
+}
+
+CurlPool::Lease CurlPool::acquire() {
+    {
+        std::lock_guard lock(idleMutex_);
+        if (!idle_.empty()) {
+            CURL* curl = idle_.back();
+            idle_.pop_back();
+            return Lease(*this, curl);
+        }
+    }
+
+    CURL* curl = curl_easy_init();
+    if (curl) configure(curl);
+    return Lease(*this, curl);
+}
+
+void CurlPool::configure(CURL* curl) const {
+    if (share_) curl_easy_setopt(curl, CURLOPT_SHARE, share_);
+    curl_easy_setopt(curl, CURLOPT_USERAGENT, "get_poi-osm/1.0 (https://github.com/Zheng-Bote/get_poi-osm)");
+    curl_easy_setopt(curl, CURLOPT_REFERER, "https://github.com/Zheng-Bote/get_poi-osm");
+
+    // Follow redirects
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+
+    // Keep idle connections alive between queries
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+
+    if (!caBundle_.empty()) curl_easy_setopt(curl, CURLOPT_CAINFO, caBundle_.c_str());
+}
+
+void CurlPool::release_(CURL* curl) {
+    // Reset per-request options; live connections and caches survive the reset
+    curl_easy_reset(curl);
+    configure(curl);
+
+    std::lock_guard lock(idleMutex_);
+    if (idle_.size() < maxIdleHandles_) {
+        idle_.push_back(curl);
+        return;
+    }
+    curl_easy_cleanup(curl);
+}
+
+std::expected<std::string, std::string> CurlPool::perform(const std::string& url, const std::string& postData) {
+    Lease handle = acquire();
+    if (!handle.get()) return std::unexpected("Failed to initialize CURL");
+
+    std::string readBuffer;
+    curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, &CurlPool::appendToString);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &readBuffer);
+
+    if (!postData.empty()) {
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDS, postData.c_str());
+    }
+
+    auto status = checkResult(handle, curl_easy_perform(handle));
+    if (!status) return std::unexpected(status.error());
+
+    return readBuffer;
+}
+
+std::expected<void, std::string> CurlPool::perform(const std::string& url, const std::string& postData,
+                                                   const ChunkSink& sink) {
+    Lease handle = acquire();
+    if (!handle.get()) return std::unexpected("Failed to initialize CURL");
+
+    curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, &CurlPool::writeToSink);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &sink);
+
+    if (!postData.empty()) {
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDS, postData.c_str());
+    }
+
+    return checkResult(handle, curl_easy_perform(handle));
+}
+
+std::string CurlPool::escape(const std::string& value) {
+    Lease handle = acquire();
+    if (!handle.get()) return "";
+
+    char* output = curl_easy_escape(handle, value.c_str(), static_cast<int>(value.length()));
+    if (output) {
+        std::string result(output);
+        curl_free(output);
+        return result;
+    }
+    return "";
+}
+
+size_t CurlPool::appendToString(void* contents, size_t size, size_t nmemb, void* userp) {
+    ((std::string*)userp)->append((char*)contents, size * nmemb);
+    return size * nmemb;
+}
+
+size_t CurlPool::writeToSink(void* contents, size_t size, size_t nmemb, void* userp) {
+    const auto& sink = *static_cast<const ChunkSink*>(userp);
+    // Any count other than the one passed in makes curl fail with CURLE_WRITE_ERROR
+    return sink(std::string_view(static_cast<const char*>(contents), size * nmemb)) ? size * nmemb : 0;
+}
+
+std::expected<void, std::string> CurlPool::checkResult(CURL* curl, CURLcode result) {
+    // An error status is the better explanation when a sink aborted the body
+    long response_code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
+    if (response_code >= 400) {
+        return std::unexpected(std::format("HTTP Error: {}", response_code));
+    }
+
+    if (result != CURLE_OK) {
+        return std::unexpected(std::format("CURL request failed: {}", curl_easy_strerror(result)));
+    }
+    return {};
+}
+
+void CurlPool::lock_(CURL*, curl_lock_data data, curl_lock_access, void* userp) {
+    static_cast<CurlPool*>(userp)->shareLocks_[data].lock();
+}
+
+void CurlPool::unlock_(CURL*, curl_lock_data data, void* userp) {
+    static_cast<CurlPool*>(userp)->shareLocks_[data].unlock();
+}
@@ -0,0 +1,158 @@
+/**
+ * SPDX-FileComment: Internal header for the pooled libcurl transport
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file CurlPool.hpp
+ * @brief Defines the CurlPool class that keeps CURL easy handles and a
+ * CURLSH share alive across PoiOsmClient requests.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <expected>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <curl/curl.h>
+
+/**
+ * @brief Long-lived pool of CURL easy handles sharing one CURLSH.
+ *
+ * Idle easy handles keep their open connections, so consecutive requests to
+ * the same host skip the TCP connect and TLS handshake; a handle added to a
+ * multi handle uses that multi's connections instead. The share object pools
+ * the DNS cache and the TLS session cache across all handles of the pool, so
+ * a new connection from any thread can still resume a TLS session. Acquiring
+ * and releasing handles is safe from several threads; each borrowed handle is
+ * used by one thread at a time. Connections are not shared, since libcurl
+ * does not support a shared connection cache for concurrent transfers.
+ */
+class CurlPool {
+public:
+    /// Receives response bytes as they arrive; returning false aborts the transfer.
+    using ChunkSink = std::function<bool(std::string_view)>;
+
+    /**
+     * @brief Creates a pool that keeps at most @p maxIdleHandles idle handles.
+     *
+     * @param maxIdleHandles Upper bound of easy handles kept for reuse.
+     * @param caBundle CA certificates file for TLS verification; empty keeps libcurl's default.
+     */
+    explicit CurlPool(std::size_t maxIdleHandles, std::string caBundle = {});
+    ~CurlPool();
+
+    CurlPool(const CurlPool&) = delete;
+    CurlPool& operator=(const CurlPool&) = delete;
+
+    /**
+     * @brief Scoped borrow of an easy handle; returns it to the pool on destruction.
+     */
+    class Lease {
+    public:
+        Lease(CurlPool& pool, CURL* curl) : pool_(&pool), curl_(curl) {}
+        ~Lease() { if (curl_) pool_->release_(curl_); }
+        Lease(Lease&& other) noexcept : pool_(other.pool_), curl_(other.curl_) { other.curl_ = nullptr; }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+
+        CURL* get() const { return curl_; }
+        operator CURL*() const { return curl_; }
+
+    private:
+        CurlPool* pool_;
+        CURL* curl_;
+    };
+
+    /**
+     * @brief Borrows an idle easy handle or creates a new one.
+     *
+     * The handle is preconfigured with the share object and the common
+     * options (user agent, referer, redirects, keep-alive).
+     *
+     * @return Lease The borrowed handle; its get() is nullptr if curl_easy_init failed.
+     */
+    Lease acquire();
+
+    /**
+     * @brief Applies the pool's common options to an easy handle.
+     *
+     * Used for handles that are not borrowed from the pool but should still
+     * participate in the shared DNS and TLS session caches.
+     *
+     * @param curl The easy handle to configure.
+     */
+    void configure(CURL* curl) const;
+
+    /**
+     * @brief Performs a blocking HTTP GET, or POST if @p postData is not empty.
+     *
+     * @param url The request URL.
+     * @param postData Form body for POST requests.
+     * @return std::expected<std::string, std::string> The response body or an error message.
+     */
+    std::expected<std::string, std::string> perform(const std::string& url, const std::string& postData = "");
+
+    /**
+     * @brief Performs a blocking request, handing the response body to @p sink chunk by chunk.
+     *
+     * @param url The request URL.
+     * @param postData Form body for POST requests; GET if empty.
+     * @param sink Receiver of the response bytes.
+     * @return std::expected<void, std::string> Empty on success, or an error message.
+     */
+    std::expected<void, std::string> perform(const std::string& url, const std::string& postData,
+                                             const ChunkSink& sink);
+
+    /**
+     * @brief URL-encodes a value.
+     *
+     * @param value The raw value.
+     * @return std::string The percent-encoded value, empty on failure.
+     */
+    std::string escape(const std::string& value);
+
+    /**
+     * @brief CURLOPT_WRITEFUNCTION that appends the received bytes to a std::string.
+     */
+    static size_t appendToString(void* contents, size_t size, size_t nmemb, void* userp);
+
+    /**
+     * @brief CURLOPT_WRITEFUNCTION that forwards the received bytes to a ChunkSink.
+     */
+    static size_t writeToSink(void* contents, size_t size, size_t nmemb, void* userp);
+
+    /**
+     * @brief Maps a finished transfer to an error message, if it failed.
+     *
+     * @param curl The easy handle of the finished transfer.
+     * @param result The transfer's CURLcode.
+     * @return std::expected<void, std::string> Empty on success, or the error message.
+     */
+    static std::expected<void, std::string> checkResult(CURL* curl, CURLcode result);
+
+private:
+    void release_(CURL* curl);
+
+    static void lock_(CURL* handle, curl_lock_data data, curl_lock_access access, void* userp);
+    static void unlock_(CURL* handle, curl_lock_data data, void* userp);
+
+    CURLSH* share_;
+    std::array<std::mutex, CURL_LOCK_DATA_LAST> shareLocks_;
+    std::mutex idleMutex_;
+    std::vector<CURL*> idle_;
+    std::size_t maxIdleHandles_;
+    std::string caBundle_;
+};
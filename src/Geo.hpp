@@ -0,0 +1,53 @@
+/**
+ * SPDX-FileComment: Internal header with geodesic helpers
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file Geo.hpp
+ * @brief Great-circle distance helpers shared by the caches and filters.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+
+namespace geo {
+
+/// Mean earth radius in meters (IUGG).
+inline constexpr double kEarthRadiusMeters = 6371008.8;
+
+/// Coordinates kept as int32 are multiples of this, OSM's own precision.
+inline constexpr double kCoordinateUnit = 1e-7;
+
+inline constexpr double toRadians(double degrees) {
+    return degrees * std::numbers::pi / 180.0;
+}
+
+/**
+ * @brief Great-circle distance between two points using the haversine formula.
+ *
+ * @return double Distance in meters.
+ */
+inline double haversineMeters(double lat1, double lon1, double lat2, double lon2) {
+    double dLat = toRadians(lat2 - lat1);
+    double dLon = toRadians(lon2 - lon1);
+    double a = std::sin(dLat / 2) * std::sin(dLat / 2) +
+               std::cos(toRadians(lat1)) * std::cos(toRadians(lat2)) * std::sin(dLon / 2) * std::sin(dLon / 2);
+    return 2.0 * kEarthRadiusMeters * std::asin(std::sqrt(std::fmin(1.0, a)));
+}
+
+/// Converts a coordinate to kCoordinateUnit.
+inline std::int32_t quantize(double degrees) {
+    return static_cast<std::int32_t>(std::llround(degrees / kCoordinateUnit));
+}
+
+} // namespace geo
@@ -0,0 +1,53 @@
+/**
+ * SPDX-FileComment: Implementation of the in-memory geocoding cache
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file GeocodeCache.cpp
+ * @brief  Implements the GeocodeCache LRU with TTL and negative caching.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "GeocodeCache.hpp"
+
+GeocodeCache::GeocodeCache(std::size_t capacity, std::chrono::seconds ttl, std::chrono::seconds negativeTtl)
+    : ttl_(ttl), negativeTtl_(negativeTtl), entries_(capacity) {}
+
+std::optional<GeocodeCache::Result> GeocodeCache::lookup(std::string_view address) {
+    if (!entries_.enabled()) return std::nullopt;
+    return entries_.lookup(normalize(address));
+}
+
+void GeocodeCache::store(std::string_view address, const Result& result) {
+    if (!entries_.enabled()) return;
+    entries_.store(normalize(address), result, result ? ttl_ : negativeTtl_);
+}
+
+PoiCacheStats GeocodeCache::stats() const {
+    return entries_.stats();
+}
+
+std::string GeocodeCache::normalize(std::string_view address) {
+    std::string key;
+    key.reserve(address.size());
+
+    bool pendingSpace = false;
+    for (char c : address) {
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            pendingSpace = !key.empty();
+            continue;
+        }
+        if (pendingSpace) {
+            key += ' ';
+            pendingSpace = false;
+        }
+        key += (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+    return key;
+}
@@ -0,0 +1,91 @@
+/**
+ * SPDX-FileComment: Internal header for the in-memory geocoding cache
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file GeocodeCache.hpp
+ * @brief Defines the GeocodeCache class, a bounded thread-safe LRU cache of
+ * Nominatim results.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "LruCache.hpp"
+#include "PoiOsm.hpp"
+
+/**
+ * @brief Bounded LRU cache mapping normalized addresses to geocoding results.
+ *
+ * Successful lookups live for the positive TTL; a "no result" answer is
+ * cached as an error for the (usually shorter) negative TTL. All methods are
+ * safe to call from several threads.
+ */
+class GeocodeCache {
+public:
+    using Result = std::expected<std::pair<double, double>, std::string>;
+
+    /// Error reported when Nominatim knows no such address; cached negatively.
+    static constexpr const char* kNoResult = "No geocoding result for address";
+
+    /**
+     * @brief Creates a cache.
+     *
+     * @param capacity Maximum number of entries; 0 disables the cache.
+     * @param ttl Lifetime of successful results.
+     * @param negativeTtl Lifetime of cached "no result" errors.
+     */
+    GeocodeCache(std::size_t capacity, std::chrono::seconds ttl, std::chrono::seconds negativeTtl);
+
+    /**
+     * @brief Looks up an address and refreshes its LRU position.
+     *
+     * @param address The address as given by the caller.
+     * @return std::optional<Result> The cached result, or std::nullopt on a miss.
+     */
+    std::optional<Result> lookup(std::string_view address);
+
+    /**
+     * @brief Stores a result, evicting the least recently used entry if full.
+     *
+     * @param address The address as given by the caller.
+     * @param result Coordinates, or an error to cache negatively.
+     */
+    void store(std::string_view address, const Result& result);
+
+    /**
+     * @brief Returns a snapshot of the hit/miss counters.
+     */
+    PoiCacheStats stats() const;
+
+    /**
+     * @brief Normalizes an address for use as cache key.
+     *
+     * Trims, collapses runs of whitespace into a single space and lower-cases
+     * ASCII letters, so "Marienplatz,  Munich" and "marienplatz, munich"
+     * share one entry.
+     *
+     * @param address The raw address.
+     * @return std::string The normalized key.
+     */
+    static std::string normalize(std::string_view address);
+
+private:
+    std::chrono::seconds ttl_;
+    std::chrono::seconds negativeTtl_;
+    LruCache<Result> entries_;
+};
@@ -0,0 +1,400 @@
+/**
+ * SPDX-FileComment: Implementation of the persistent geocoding store
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file GeocodeStore.cpp
+ * @brief  Implements GeocodeStore on mmap(), pwrite() and flock().
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "GeocodeStore.hpp"
+
+#ifndef _WIN32
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kLogMagic[8] = {'G', 'P', 'O', 'I', 'G', 'E', 'O', 'L'};
+constexpr char kIndexMagic[8] = {'G', 'P', 'O', 'I', 'G', 'E', 'O', 'I'};
+constexpr std::uint32_t kFormatVersion = 1;
+constexpr std::uint64_t kInitialCapacity = 4096;
+
+constexpr std::uint32_t kKindNoResult = 0;
+constexpr std::uint32_t kKindCoordinates = 1;
+
+struct LogHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+};
+
+// Followed by keyLength bytes of key, padded to 8 bytes
+struct RecordHeader {
+    std::uint32_t keyLength;
+    std::uint32_t kind;
+    std::int64_t storedAt; // seconds since epoch
+    double lat;
+    double lon;
+};
+
+struct IndexHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t capacity; // power of two
+    std::uint64_t count;
+};
+
+// offset == 0 marks an empty bucket (offset 0 holds the log header)
+struct Bucket {
+    std::uint64_t hash;
+    std::uint64_t offset;
+};
+
+std::uint64_t fnv1a(std::string_view s) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : s) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::size_t align8(std::size_t n) {
+    return (n + 7) & ~std::size_t{7};
+}
+
+std::string errnoText() {
+    return std::strerror(errno);
+}
+
+std::int64_t nowSeconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string indexPath(const std::string& path) {
+    return path + ".idx";
+}
+
+Bucket* bucketsOf(void* indexData) {
+    return reinterpret_cast<Bucket*>(static_cast<char*>(indexData) + sizeof(IndexHeader));
+}
+
+std::uint64_t loadOffset(Bucket& bucket) {
+    return std::atomic_ref<std::uint64_t>(bucket.offset).load(std::memory_order_acquire);
+}
+
+void publishOffset(Bucket& bucket, std::uint64_t offset) {
+    std::atomic_ref<std::uint64_t>(bucket.offset).store(offset, std::memory_order_release);
+}
+
+// Exclusive advisory lock serializing writers across processes
+class WriterLock {
+public:
+    explicit WriterLock(int fd) : fd_(fd) { while (::flock(fd_, LOCK_EX) != 0 && errno == EINTR) {} }
+    ~WriterLock() { ::flock(fd_, LOCK_UN); }
+    WriterLock(const WriterLock&) = delete;
+    WriterLock& operator=(const WriterLock&) = delete;
+
+private:
+    int fd_;
+};
+
+// Writes an index of the given capacity to path, re-inserting the old buckets
+std::expected<void, std::string> writeIndexFile(const std::string& path, std::uint64_t capacity,
+                                                const Bucket* old, std::uint64_t oldCapacity) {
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return std::unexpected(std::format("Cannot create geocode index {}: {}", path, errnoText()));
+
+    std::size_t size = sizeof(IndexHeader) + capacity * sizeof(Bucket);
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        return std::unexpected(std::format("Cannot size geocode index {}: {}", path, errnoText()));
+    }
+
+    void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) return std::unexpected(std::format("Cannot map geocode index {}: {}", path, errnoText()));
+
+    auto* header = static_cast<IndexHeader*>(data);
+    std::memcpy(header->magic, kIndexMagic, sizeof(kIndexMagic));
+    header->version = kFormatVersion;
+    header->capacity = capacity;
+    header->count = 0;
+
+    Bucket* buckets = bucketsOf(data);
+    for (std::uint64_t i = 0; i < oldCapacity; ++i) {
+        if (old[i].offset == 0) continue;
+        std::uint64_t slot = old[i].hash & (capacity - 1);
+        while (buckets[slot].offset != 0) slot = (slot + 1) & (capacity - 1);
+        buckets[slot] = old[i];
+        ++header->count;
+    }
+
+    ::msync(data, size, MS_SYNC);
+    ::munmap(data, size);
+    return {};
+}
+
+// Writes the index next to path and renames it into place, so that other
+// processes only ever map a complete index
+std::expected<void, std::string> replaceIndexFile(const std::string& path, std::uint64_t capacity,
+                                                  const Bucket* old, std::uint64_t oldCapacity) {
+    std::string tmpPath = path + ".tmp";
+    auto written = writeIndexFile(tmpPath, capacity, old, oldCapacity);
+    if (!written) return written;
+
+    // Readers holding an old mapping keep a consistent, if stale, view
+    if (::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        return std::unexpected(std::format("Cannot replace geocode index {}: {}", path, errnoText()));
+    }
+    return {};
+}
+
+} // namespace
+
+std::expected<std::unique_ptr<GeocodeStore>, std::string> GeocodeStore::open(const std::string& path) {
+    bool writable = true;
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        writable = false;
+        fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    }
+    if (fd < 0) return std::unexpected(std::format("Cannot open geocode store {}: {}", path, errnoText()));
+
+    std::unique_ptr<GeocodeStore> store(new GeocodeStore(path, fd, writable));
+
+    if (writable) {
+        WriterLock lock(fd);
+        struct stat st {};
+        if (::fstat(fd, &st) == 0 && st.st_size == 0) {
+            LogHeader header{};
+            std::memcpy(header.magic, kLogMagic, sizeof(kLogMagic));
+            header.version = kFormatVersion;
+            if (::pwrite(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+                return std::unexpected(std::format("Cannot initialize geocode store {}: {}", path, errnoText()));
+            }
+        }
+        if (::access(indexPath(path).c_str(), F_OK) != 0) {
+            auto created = replaceIndexFile(indexPath(path), kInitialCapacity, nullptr, 0);
+            if (!created) return std::unexpected(created.error());
+        }
+    }
+
+    LogHeader header{};
+    if (::pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+        std::memcmp(header.magic, kLogMagic, sizeof(kLogMagic)) != 0 || header.version != kFormatVersion) {
+        return std::unexpected(std::format("{} is not a geocode store (version {})", path, kFormatVersion));
+    }
+
+    auto mapped = store->mapIndex_();
+    if (!mapped) return std::unexpected(mapped.error());
+
+    return store;
+}
+
+GeocodeStore::GeocodeStore(std::string path, int logFd, bool writable)
+    : path_(std::move(path)), logFd_(logFd), writable_(writable) {}
+
+GeocodeStore::~GeocodeStore() {
+    if (log_.data) ::munmap(log_.data, log_.size);
+    if (index_.data) ::munmap(index_.data, index_.size);
+    if (indexFd_ >= 0) ::close(indexFd_);
+    ::close(logFd_);
+}
+
+std::optional<GeocodeCache::Result> GeocodeStore::lookup(std::string_view address,
+                                                         std::chrono::seconds ttl,
+                                                         std::chrono::seconds negativeTtl) {
+    std::string key = GeocodeCache::normalize(address);
+    std::uint64_t hash = fnv1a(key);
+    std::lock_guard lock(mutex_);
+
+    Probe probe = probe_(key, hash);
+    // Another process may have replaced the index with a larger one
+    if (!probe.found && refreshIndex_()) probe = probe_(key, hash);
+    if (!probe.found) return std::nullopt;
+
+    // The bucket may have been republished since; only the offset probe_()
+    // checked against the log mapping is safe to read
+    const auto* record =
+        reinterpret_cast<const RecordHeader*>(static_cast<const char*>(log_.data) + probe.offset);
+
+    auto maxAge = record->kind == kKindCoordinates ? ttl : negativeTtl;
+    if (nowSeconds() - record->storedAt > maxAge.count()) return std::nullopt;
+
+    if (record->kind == kKindNoResult) return GeocodeCache::Result(std::unexpected(GeocodeCache::kNoResult));
+    return GeocodeCache::Result(std::make_pair(record->lat, record->lon));
+}
+
+std::expected<void, std::string> GeocodeStore::store(std::string_view address, const GeocodeCache::Result& result) {
+    if (!writable_) return std::unexpected(std::format("Geocode store {} is read-only", path_));
+
+    std::string key = GeocodeCache::normalize(address);
+    std::uint64_t hash = fnv1a(key);
+    std::lock_guard lock(mutex_);
+    WriterLock writerLock(logFd_);
+
+    refreshIndex_();
+    const auto* header = static_cast<const IndexHeader*>(index_.data);
+    if ((header->count + 1) * 10 > header->capacity * 7) {
+        auto grown = growIndex_();
+        if (!grown) return grown;
+    }
+
+    // Append the record first; it only becomes visible once the index points at it
+    RecordHeader record{};
+    record.keyLength = static_cast<std::uint32_t>(key.size());
+    record.kind = result ? kKindCoordinates : kKindNoResult;
+    record.storedAt = nowSeconds();
+    if (result) {
+        record.lat = result->first;
+        record.lon = result->second;
+    }
+
+    std::vector<char> buffer(align8(sizeof(RecordHeader) + key.size()), '\0');
+    std::memcpy(buffer.data(), &record, sizeof(record));
+    std::memcpy(buffer.data() + sizeof(record), key.data(), key.size());
+
+    off_t end = ::lseek(logFd_, 0, SEEK_END);
+    if (end < 0 || ::pwrite(logFd_, buffer.data(), buffer.size(), end) != static_cast<ssize_t>(buffer.size())) {
+        return std::unexpected(std::format("Cannot append to geocode store {}: {}", path_, errnoText()));
+    }
+
+    Probe probe = probe_(key, hash);
+    Bucket& bucket = bucketsOf(index_.data)[probe.slot];
+    if (!probe.found) {
+        bucket.hash = hash;
+        ++static_cast<IndexHeader*>(index_.data)->count;
+    }
+    publishOffset(bucket, static_cast<std::uint64_t>(end));
+    return {};
+}
+
+std::expected<void, std::string> GeocodeStore::mapIndex_() {
+    std::string path = indexPath(path_);
+    int fd = ::open(path.c_str(), (writable_ ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+    if (fd < 0) return std::unexpected(std::format("Cannot open geocode index {}: {}", path, errnoText()));
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(IndexHeader)) {
+        ::close(fd);
+        return std::unexpected(std::format("Geocode index {} is truncated", path));
+    }
+
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+    void* data = ::mmap(nullptr, size, PROT_READ | (writable_ ? PROT_WRITE : 0), MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        ::close(fd);
+        return std::unexpected(std::format("Cannot map geocode index {}: {}", path, errnoText()));
+    }
+
+    const auto* header = static_cast<const IndexHeader*>(data);
+    bool valid = std::memcmp(header->magic, kIndexMagic, sizeof(kIndexMagic)) == 0 &&
+                 header->version == kFormatVersion && header->capacity != 0 &&
+                 (header->capacity & (header->capacity - 1)) == 0 &&
+                 size == sizeof(IndexHeader) + header->capacity * sizeof(Bucket);
+    if (!valid) {
+        ::munmap(data, size);
+        ::close(fd);
+        return std::unexpected(std::format("{} is not a geocode index (version {})", path, kFormatVersion));
+    }
+
+    if (index_.data) ::munmap(index_.data, index_.size);
+    if (indexFd_ >= 0) ::close(indexFd_);
+    index_ = Mapping{data, size};
+    indexFd_ = fd;
+    indexInode_ = static_cast<std::uint64_t>(st.st_ino);
+    return {};
+}
+
+bool GeocodeStore::refreshIndex_() {
+    struct stat st {};
+    if (::stat(indexPath(path_).c_str(), &st) != 0) return false;
+    if (static_cast<std::uint64_t>(st.st_ino) == indexInode_) return false;
+    return mapIndex_().has_value();
+}
+
+bool GeocodeStore::mapLog_(std::size_t minSize) {
+    if (log_.size >= minSize) return true;
+
+    struct stat st {};
+    if (::fstat(logFd_, &st) != 0 || static_cast<std::size_t>(st.st_size) < minSize) return false;
+
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, logFd_, 0);
+    if (data == MAP_FAILED) return false;
+
+    if (log_.data) ::munmap(log_.data, log_.size);
+    log_ = Mapping{data, size};
+    return true;
+}
+
+GeocodeStore::Probe GeocodeStore::probe_(std::string_view key, std::uint64_t hash) {
+    const auto* header = static_cast<const IndexHeader*>(index_.data);
+    std::uint64_t mask = header->capacity - 1;
+    Bucket* buckets = bucketsOf(index_.data);
+
+    std::uint64_t slot = hash & mask;
+    for (std::uint64_t probes = 0; probes <= mask; ++probes, slot = (slot + 1) & mask) {
+        std::uint64_t offset = loadOffset(buckets[slot]);
+        if (offset == 0) return {slot, 0, false};
+        if (buckets[slot].hash != hash) continue;
+
+        if (!mapLog_(offset + sizeof(RecordHeader))) continue;
+        const auto* record = reinterpret_cast<const RecordHeader*>(static_cast<const char*>(log_.data) + offset);
+        if (record->keyLength != key.size() || !mapLog_(offset + sizeof(RecordHeader) + key.size())) continue;
+
+        const char* recordKey = static_cast<const char*>(log_.data) + offset + sizeof(RecordHeader);
+        if (std::string_view(recordKey, key.size()) == key) return {slot, offset, true};
+    }
+    return {slot, 0, false};
+}
+
+std::expected<void, std::string> GeocodeStore::growIndex_() {
+    const auto* header = static_cast<const IndexHeader*>(index_.data);
+    auto written =
+        replaceIndexFile(indexPath(path_), header->capacity * 2, bucketsOf(index_.data), header->capacity);
+    if (!written) return written;
+    return mapIndex_();
+}
+
+#else
+
+GeocodeStore::GeocodeStore(std::string path, int logFd, bool writable)
+    : path_(std::move(path)), logFd_(logFd), writable_(writable) {}
+
+GeocodeStore::~GeocodeStore() = default;
+
+std::expected<std::unique_ptr<GeocodeStore>, std::string> GeocodeStore::open(const std::string&) {
+    return std::unexpected("The persistent geocode store is not supported on this platform");
+}
+
+std::optional<GeocodeCache::Result> GeocodeStore::lookup(std::string_view, std::chrono::seconds, std::chrono::seconds) {
+    return std::nullopt;
+}
+
+std::expected<void, std::string> GeocodeStore::store(std::string_view, const GeocodeCache::Result&) {
+    return std::unexpected("The persistent geocode store is not supported on this platform");
+}
+
+#endif
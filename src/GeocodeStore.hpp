@@ -0,0 +1,116 @@
+/**
+ * SPDX-FileComment: Internal header for the persistent geocoding store
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file GeocodeStore.hpp
+ * @brief Defines the GeocodeStore class, an on-disk geocoding cache shared
+ * by concurrent processes.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "GeocodeCache.hpp"
+
+/**
+ * @brief Persistent geocoding cache made of an append-only log and a hash index.
+ *
+ * Layout on disk:
+ * - `<path>`: append-only log of records (key, coordinates or "no result",
+ *   store time). Records are never modified after they are written.
+ * - `<path>.idx`: open-addressing hash table of (key hash, log offset) pairs.
+ *
+ * Both files are memory-mapped. A lookup hashes the normalized address,
+ * probes the index and compares the key of the referenced log record, so no
+ * file is ever parsed as a whole. Readers take no lock: a writer appends the
+ * record first and publishes its offset in the index last. Writers of all
+ * processes are serialized by an exclusive flock() on the log. When the
+ * index fills up, the writer builds a larger one and renames it into place;
+ * other processes notice the replaced file and re-map it.
+ */
+class GeocodeStore {
+public:
+    /**
+     * @brief Opens or creates the store at @p path.
+     *
+     * Falls back to read-only access if the files are not writable.
+     *
+     * @param path Path of the log file; the index lives at `<path>.idx`.
+     * @return std::expected<std::unique_ptr<GeocodeStore>, std::string> The store or an error message.
+     */
+    static std::expected<std::unique_ptr<GeocodeStore>, std::string> open(const std::string& path);
+
+    ~GeocodeStore();
+
+    GeocodeStore(const GeocodeStore&) = delete;
+    GeocodeStore& operator=(const GeocodeStore&) = delete;
+
+    /**
+     * @brief Looks up an address.
+     *
+     * @param address The address as given by the caller.
+     * @param ttl Maximum age of cached coordinates.
+     * @param negativeTtl Maximum age of cached "no result" answers.
+     * @return std::optional<GeocodeCache::Result> The cached result, or std::nullopt on a miss.
+     */
+    std::optional<GeocodeCache::Result> lookup(std::string_view address,
+                                               std::chrono::seconds ttl,
+                                               std::chrono::seconds negativeTtl);
+
+    /**
+     * @brief Appends a result; a later record for the same address supersedes earlier ones.
+     *
+     * @param address The address as given by the caller.
+     * @param result Coordinates, or an error to remember as "no result".
+     * @return std::expected<void, std::string> Empty on success, or an error message.
+     */
+    std::expected<void, std::string> store(std::string_view address, const GeocodeCache::Result& result);
+
+private:
+    struct Mapping {
+        void* data = nullptr;
+        std::size_t size = 0;
+    };
+
+    // Outcome of probe_(): the key's bucket, or the free bucket it would take
+    struct Probe {
+        std::uint64_t slot;
+        std::uint64_t offset; // Log offset of the matching record, checked against the log mapping
+        bool found;
+    };
+
+    GeocodeStore(std::string path, int logFd, bool writable);
+
+    std::expected<void, std::string> mapIndex_();
+    bool refreshIndex_();
+    bool mapLog_(std::size_t minSize);
+    Probe probe_(std::string_view key, std::uint64_t hash);
+    std::expected<void, std::string> growIndex_();
+
+    std::string path_;
+    int logFd_;
+    int indexFd_ = -1;
+    bool writable_;
+    std::uint64_t indexInode_ = 0;
+    Mapping log_;
+    Mapping index_;
+    std::mutex mutex_;
+};
@@ -0,0 +1,296 @@
+/**
+ * SPDX-FileComment: Implementation of the static spatial index
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file GridIndex.cpp
+ * @brief Implements the Hilbert curve keys and the quadtree walks of GridIndex.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "GridIndex.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <numeric>
+#include <queue>
+
+namespace {
+
+// The Hilbert grid has 2^kLevels cells along each side
+constexpr std::uint32_t kLevels = 16;
+constexpr std::uint32_t kSide = 1u << kLevels;
+
+// Quadrants are only dropped when they are this much farther than the radius,
+// so rounding never loses a point on the circle
+constexpr double kPruneSlackMeters = 0.01;
+
+// Row and column of the cell at @p key on the Hilbert curve
+std::pair<std::uint32_t, std::uint32_t> hilbertCell(std::uint32_t key) {
+    std::uint32_t row = 0;
+    std::uint32_t column = 0;
+    for (std::uint32_t side = 1; side < kSide; side <<= 1) {
+        std::uint32_t rx = 1 & (key >> 1);
+        std::uint32_t ry = 1 & (key ^ rx);
+        if (ry == 0) {
+            if (rx == 1) {
+                column = side - 1 - column;
+                row = side - 1 - row;
+            }
+            std::swap(column, row);
+        }
+        column += side * rx;
+        row += side * ry;
+        key >>= 2;
+    }
+    return {row, column};
+}
+
+} // namespace
+
+namespace grid {
+
+std::uint32_t hilbertKey(std::uint32_t row, std::uint32_t column) {
+    std::uint32_t key = 0;
+    for (std::uint32_t side = kSide / 2; side > 0; side >>= 1) {
+        std::uint32_t rx = (column & side) ? 1 : 0;
+        std::uint32_t ry = (row & side) ? 1 : 0;
+        key += side * side * ((3 * rx) ^ ry);
+        // Rotate the quadrant so the curve inside it starts and ends at the right corners
+        if (ry == 0) {
+            if (rx == 1) {
+                column = kSide - 1 - column;
+                row = kSide - 1 - row;
+            }
+            std::swap(column, row);
+        }
+    }
+    return key;
+}
+
+double minDistanceMeters(double lat, double lon, const tiles::BBox& box) {
+    double a = tiles::minHaversine(lat, lon, std::cos(geo::toRadians(lat)), box);
+    return 2.0 * geo::kEarthRadiusMeters * std::asin(std::sqrt(std::fmin(1.0, a)));
+}
+
+} // namespace grid
+
+GridIndex::GridIndex(const std::int32_t* lats, const std::int32_t* lons, std::size_t count,
+                     const grid::Cell* cells, std::size_t cellCount, std::uint32_t cellsPerDegree)
+    : lats_(lats), lons_(lons), count_(count), cells_(cells), cellCount_(cellCount),
+      cellsPerDegree_(std::clamp<std::uint32_t>(cellsPerDegree, 1, grid::kMaxCellsPerDegree)) {}
+
+void GridIndex::build(const std::vector<std::int32_t>& lats, const std::vector<std::int32_t>& lons,
+                      std::uint32_t cellsPerDegree, std::vector<std::size_t>& order,
+                      std::vector<grid::Cell>& cells) {
+    std::size_t count = std::min(lats.size(), lons.size());
+    std::vector<std::uint32_t> keys(count);
+    for (std::size_t i = 0; i < count; ++i) keys[i] = grid::cellKey(lats[i], lons[i], cellsPerDegree);
+
+    order.resize(count);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::ranges::stable_sort(order, {}, [&keys](std::size_t i) { return keys[i]; });
+
+    cells.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint32_t key = keys[order[i]];
+        if (cells.empty() || cells.back().key != key) cells.push_back({key, static_cast<std::uint32_t>(i)});
+    }
+}
+
+std::vector<GridIndex::Neighbor> GridIndex::nearest(double lat, double lon, std::size_t count, double maxRadiusMeters,
+                                                    const std::function<bool(std::size_t, double)>& accept) const {
+    std::vector<Neighbor> found;
+    if (count == 0 || cellCount_ == 0 || count_ == 0) return found;
+
+    // A queue entry is either a quadrant (at its least distance) or a point
+    struct Candidate {
+        double distanceMeters;
+        bool point;
+        std::size_t index;
+        Quadrant quadrant;
+    };
+    auto farther = [](const Candidate& a, const Candidate& b) { return a.distanceMeters > b.distanceMeters; };
+    std::priority_queue<Candidate, std::vector<Candidate>, decltype(farther)> queue(farther);
+    queue.push({0.0, false, 0, quadrant_(0, 0, kLevels)});
+    double cosLat = std::cos(geo::toRadians(lat));
+    geo::RadiusFilter filter(lat, lon, maxRadiusMeters);
+    std::array<std::uint32_t, kFilterBlock> inside;
+    std::array<double, kFilterBlock> distances;
+
+    std::array<Quadrant, 4> children;
+    while (!queue.empty() && found.size() < count) {
+        Candidate next = queue.top();
+        queue.pop();
+        if (next.distanceMeters > maxRadiusMeters) break;
+
+        if (next.point) {
+            if (accept(next.index, next.distanceMeters)) found.push_back({next.index, next.distanceMeters});
+            continue;
+        }
+
+        const Quadrant& q = next.quadrant;
+        if (q.level == 0 || q.lastCell - q.firstCell == 1) {
+            // A single cell: its points go into the queue at their own distance
+            std::size_t first = firstPoint_(q.firstCell);
+            std::size_t last = std::max(first, firstPoint_(q.lastCell));
+            for (std::size_t block = first; block < last; block += kFilterBlock) {
+                std::size_t found = filter.filter(lats_ + block, lons_ + block, std::min(kFilterBlock, last - block),
+                                                  inside.data(), distances.data());
+                for (std::size_t j = 0; j < found; ++j) queue.push({distances[j], true, block + inside[j], {}});
+            }
+            continue;
+        }
+
+        std::size_t n = split_(q, children);
+        for (std::size_t c = 0; c < n; ++c) {
+            double a = tiles::minHaversine(lat, lon, cosLat, bounds_(children[c]));
+            double distance = 2.0 * geo::kEarthRadiusMeters * std::asin(std::sqrt(std::fmin(1.0, a)));
+            if (distance <= maxRadiusMeters) queue.push({distance, false, 0, children[c]});
+        }
+    }
+    return found;
+}
+
+std::vector<std::pair<std::size_t, std::size_t>> GridIndex::runs_(const tiles::BBox& area,
+                                                                  const Circle* circle) const {
+    std::vector<std::pair<std::size_t, std::size_t>> runs;
+    if (cellCount_ == 0 || count_ == 0 || area.south > area.north || area.west > area.east) return runs;
+
+    auto row = [this](double lat) {
+        return grid::cellRow(geo::quantize(std::clamp(lat, -90.0, 90.0)), cellsPerDegree_);
+    };
+    auto column = [this](double lon) {
+        return grid::cellColumn(geo::quantize(std::clamp(lon, -180.0, 180.0)), cellsPerDegree_);
+    };
+    std::uint32_t firstRow = row(area.south);
+    std::uint32_t lastRow = row(area.north);
+    std::uint32_t firstColumn = column(area.west);
+    std::uint32_t lastColumn = column(area.east);
+
+    auto emit = [&](const Quadrant& q) {
+        std::size_t first = firstPoint_(q.firstCell);
+        std::size_t last = std::max(first, firstPoint_(q.lastCell));
+        if (first < last) runs.emplace_back(first, last);
+    };
+
+    // Start from the aligned quadrants, at most four, of the smallest size
+    // that a side of the area can span only two of
+    std::uint32_t level = std::min<std::uint32_t>(
+        kLevels, static_cast<std::uint32_t>(std::bit_width(std::max(lastRow - firstRow, lastColumn - firstColumn))));
+    std::uint32_t mask = level == kLevels ? 0 : ~((1u << level) - 1);
+    std::vector<Quadrant> stack;
+    for (std::uint32_t r : {firstRow & mask, lastRow & mask}) {
+        for (std::uint32_t c : {firstColumn & mask, lastColumn & mask}) {
+            bool seen = std::ranges::any_of(stack, [&](const Quadrant& q) { return q.row == r && q.column == c; });
+            if (!seen) stack.push_back(quadrant_(r, c, level));
+        }
+    }
+
+    // Quadrants near the circle but outside it are dropped by their least
+    // haversine term, compared without converting it to meters
+    double cosLat = circle ? std::cos(geo::toRadians(circle->lat)) : 0.0;
+    double reach = circle ? std::min((circle->radiusMeters + kPruneSlackMeters) / geo::kEarthRadiusMeters,
+                                     std::numbers::pi) : 0.0;
+    double maxHaversine = std::sin(reach / 2) * std::sin(reach / 2);
+
+    std::array<Quadrant, 4> children;
+    while (!stack.empty()) {
+        Quadrant q = stack.back();
+        stack.pop_back();
+        if (q.firstCell >= q.lastCell) continue;
+
+        std::uint32_t last = (1u << q.level) - 1;
+        if (q.row > lastRow || q.row + last < firstRow || q.column > lastColumn || q.column + last < firstColumn) {
+            continue;
+        }
+        if (circle && tiles::minHaversine(circle->lat, circle->lon, cosLat, bounds_(q)) > maxHaversine) continue;
+
+        bool inside = q.row >= firstRow && q.row + last <= lastRow && q.column >= firstColumn &&
+                      q.column + last <= lastColumn;
+        if (inside || q.level == 0) {
+            emit(q);
+            continue;
+        }
+        if (q.lastCell - q.firstCell == 1) {
+            // A lone cell needs no further splitting: test it directly
+            auto [cellRow, cellColumn] = hilbertCell(cells_[q.firstCell].key);
+            if (cellRow >= firstRow && cellRow <= lastRow && cellColumn >= firstColumn && cellColumn <= lastColumn) {
+                emit(q);
+            }
+            continue;
+        }
+
+        std::size_t n = split_(q, children);
+        stack.insert(stack.end(), children.begin(), children.begin() + static_cast<std::ptrdiff_t>(n));
+    }
+
+    // Quadrants come out of the stack in no particular order; adjacent runs
+    // are merged so the caller reads each stretch of memory in one go
+    std::ranges::sort(runs);
+    std::size_t merged = 0;
+    for (std::size_t i = 0; i < runs.size(); ++i) {
+        if (merged > 0 && runs[i].first <= runs[merged - 1].second) {
+            runs[merged - 1].second = std::max(runs[merged - 1].second, runs[i].second);
+        } else {
+            runs[merged++] = runs[i];
+        }
+    }
+    runs.resize(merged);
+    return runs;
+}
+
+GridIndex::Quadrant GridIndex::quadrant_(std::uint32_t row, std::uint32_t column, std::uint32_t level) const {
+    // The cells of an aligned quadrant share the key bits above its own
+    std::uint64_t span = std::uint64_t{1} << (2 * level);
+    std::uint64_t firstKey = grid::hilbertKey(row, column) & ~(span - 1);
+    auto lower = [this](std::uint64_t key) {
+        return static_cast<std::size_t>(
+            std::lower_bound(cells_, cells_ + cellCount_, key,
+                             [](const grid::Cell& c, std::uint64_t k) { return c.key < k; }) -
+            cells_);
+    };
+    return Quadrant{row, column, level, lower(firstKey), lower(firstKey + span)};
+}
+
+std::size_t GridIndex::split_(const Quadrant& quadrant, std::array<Quadrant, 4>& children) const {
+    // The children are consecutive quarters of the parent's key range, so
+    // three searches within the parent's directory entries divide them
+    std::uint32_t level = quadrant.level - 1;
+    std::uint32_t half = 1u << level;
+    std::uint64_t span = std::uint64_t{1} << (2 * level);
+    std::uint64_t firstKey = grid::hilbertKey(quadrant.row, quadrant.column) & ~(4 * span - 1);
+    std::array<std::size_t, 5> bounds{quadrant.firstCell, 0, 0, 0, quadrant.lastCell};
+    const grid::Cell* first = cells_ + quadrant.firstCell;
+    for (std::size_t j = 1; j < 4; ++j) {
+        first = std::lower_bound(first, cells_ + quadrant.lastCell, firstKey + j * span,
+                                 [](const grid::Cell& c, std::uint64_t k) { return c.key < k; });
+        bounds[j] = static_cast<std::size_t>(first - cells_);
+    }
+
+    std::size_t n = 0;
+    for (auto [dRow, dColumn] : {std::pair{0u, 0u}, {0u, half}, {half, 0u}, {half, half}}) {
+        std::uint32_t row = quadrant.row + dRow;
+        std::uint32_t column = quadrant.column + dColumn;
+        std::size_t j = (grid::hilbertKey(row, column) - firstKey) / span;
+        if (bounds[j] < bounds[j + 1]) children[n++] = Quadrant{row, column, level, bounds[j], bounds[j + 1]};
+    }
+    return n;
+}
+
+std::size_t GridIndex::firstPoint_(std::size_t c) const {
+    return c < cellCount_ ? std::min<std::size_t>(cells_[c].first, count_) : count_;
+}
+
+tiles::BBox GridIndex::bounds_(const Quadrant& quadrant) const {
+    double side = static_cast<double>(std::uint64_t{1} << quadrant.level);
+    double cell = 1.0 / cellsPerDegree_;
+    return tiles::BBox{quadrant.row * cell - 90.0, quadrant.column * cell - 180.0,
+                       (quadrant.row + side) * cell - 90.0, (quadrant.column + side) * cell - 180.0};
+}
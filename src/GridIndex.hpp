@@ -0,0 +1,248 @@
+/**
+ * SPDX-FileComment: Internal header for the static spatial index
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file GridIndex.hpp
+ * @brief Defines GridIndex, a static uniform grid over points sorted by the
+ * Hilbert curve order of their cells, with circle, bounding box and nearest
+ * neighbour queries.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numbers>
+#include <utility>
+#include <vector>
+
+#include "Geo.hpp"
+#include "RadiusFilter.hpp"
+#include "Tiles.hpp"
+
+namespace grid {
+
+/// Largest cells-per-degree value whose rows and columns fit the 2^16 Hilbert grid.
+inline constexpr std::uint32_t kMaxCellsPerDegree = 128;
+
+/// One non-empty grid cell; its points run up to the next cell's first (or the end).
+struct Cell {
+    std::uint32_t key;   ///< hilbertKey() of the cell.
+    std::uint32_t first; ///< Index of its first point.
+};
+
+/// Grid row of a quantized latitude, counted from the south pole.
+inline std::uint32_t cellRow(std::int32_t lat, std::uint32_t cellsPerDegree) {
+    return static_cast<std::uint32_t>((std::int64_t{lat} + 900'000'000) * cellsPerDegree / 10'000'000);
+}
+
+/// Grid column of a quantized longitude, counted from the antimeridian.
+inline std::uint32_t cellColumn(std::int32_t lon, std::uint32_t cellsPerDegree) {
+    return static_cast<std::uint32_t>((std::int64_t{lon} + 1'800'000'000) * cellsPerDegree / 10'000'000);
+}
+
+/**
+ * @brief Position of a cell on the Hilbert curve through the 2^16 x 2^16 grid.
+ *
+ * Cells that are close on the curve are close on the map, and every aligned
+ * square of 2^k x 2^k cells is one contiguous run of keys.
+ */
+std::uint32_t hilbertKey(std::uint32_t row, std::uint32_t column);
+
+/// Key of the cell holding a quantized coordinate.
+inline std::uint32_t cellKey(std::int32_t lat, std::int32_t lon, std::uint32_t cellsPerDegree) {
+    return hilbertKey(cellRow(lat, cellsPerDegree), cellColumn(lon, cellsPerDegree));
+}
+
+/**
+ * @brief Smallest great-circle distance from a point to any point of a box.
+ *
+ * A lower bound used to prune; the box must not cross the antimeridian.
+ *
+ * @return double Distance in meters; 0 inside the box.
+ */
+double minDistanceMeters(double lat, double lon, const tiles::BBox& box);
+
+} // namespace grid
+
+/**
+ * @brief Read-only spatial index over points stored as columns.
+ *
+ * The points are sorted by the Hilbert key of their grid cell, so the
+ * points of a cell are contiguous and neighbouring cells mostly lie next
+ * to each other in memory. The index itself is the sorted list of
+ * non-empty cells (the directory); it points into the caller's arrays
+ * and copies nothing, so it works over a memory-mapped file as well as
+ * over vectors.
+ *
+ * Queries walk the implicit quadtree of the Hilbert curve: a quadrant is a
+ * key range, skipped when the directory holds no cell in it or when it
+ * cannot touch the query area, and taken whole when it lies inside. A
+ * query therefore touches a few runs of adjacent points instead of one
+ * run per grid row. Indices read from the directory are clamped to the
+ * point count, so a corrupt directory yields wrong results, never reads
+ * out of bounds.
+ */
+class GridIndex {
+public:
+    /// A point found by nearest(), with its distance.
+    struct Neighbor {
+        std::size_t index;
+        double distanceMeters;
+    };
+
+    GridIndex() = default;
+
+    /**
+     * @param lats Quantized latitude per point.
+     * @param lons Quantized longitude per point.
+     * @param count Number of points.
+     * @param cells The non-empty cells, by key.
+     * @param cellCount Number of cells.
+     * @param cellsPerDegree Grid resolution the keys were computed with.
+     */
+    GridIndex(const std::int32_t* lats, const std::int32_t* lons, std::size_t count,
+              const grid::Cell* cells, std::size_t cellCount, std::uint32_t cellsPerDegree);
+
+    /**
+     * @brief Sorts points into cell order and builds the directory for them.
+     *
+     * For points held in memory: reorder the point arrays by @p order
+     * (order[i] is the old index of the new point i), then construct the
+     * index over them with @p cells.
+     *
+     * @param lats Quantized latitude per point.
+     * @param lons Quantized longitude per point.
+     * @param cellsPerDegree Grid resolution.
+     * @param order Receives the permutation.
+     * @param cells Receives the directory.
+     */
+    static void build(const std::vector<std::int32_t>& lats, const std::vector<std::int32_t>& lons,
+                      std::uint32_t cellsPerDegree, std::vector<std::size_t>& order,
+                      std::vector<grid::Cell>& cells);
+
+    /// Number of indexed points.
+    std::size_t size() const { return count_; }
+
+    /**
+     * @brief Calls @p visit(index) for every point inside a bounding box.
+     *
+     * The box must not cross the antimeridian.
+     */
+    template <typename Visit>
+    void box(const tiles::BBox& area, Visit&& visit) const {
+        std::int32_t south = geo::quantize(area.south);
+        std::int32_t west = geo::quantize(area.west);
+        std::int32_t north = geo::quantize(area.north);
+        std::int32_t east = geo::quantize(area.east);
+        for (auto [first, last] : runs_(area, nullptr)) {
+            for (std::size_t i = first; i < last; ++i) {
+                if (lats_[i] >= south && lats_[i] <= north && lons_[i] >= west && lons_[i] <= east) visit(i);
+            }
+        }
+    }
+
+    /**
+     * @brief Calls @p visit(index, distanceMeters) for every point within a circle.
+     *
+     * The points of the candidate runs go through geo::RadiusFilter a block
+     * at a time, so the distance test runs on vectors of points.
+     */
+    template <typename Visit>
+    void circle(double lat, double lon, double radiusMeters, Visit&& visit) const {
+        // circleBounds() stops at the Web Mercator limit; the grid goes on to the poles
+        auto area = tiles::circleBounds(lat, lon, radiusMeters);
+        double dLat = radiusMeters / geo::kEarthRadiusMeters * 180.0 / std::numbers::pi;
+        area.south = std::max(lat - dLat, -90.0);
+        area.north = std::min(lat + dLat, 90.0);
+        Circle query{lat, lon, radiusMeters};
+        geo::RadiusFilter filter(lat, lon, radiusMeters);
+        std::array<std::uint32_t, kFilterBlock> inside;
+        std::array<double, kFilterBlock> distances;
+        // A circle crossing the antimeridian is searched on both sides of it
+        for (const auto& piece : tiles::splitAntimeridian(area)) {
+            for (auto [first, last] : runs_(piece, &query)) {
+                for (std::size_t block = first; block < last; block += kFilterBlock) {
+                    std::size_t found = filter.filter(lats_ + block, lons_ + block,
+                                                      std::min(kFilterBlock, last - block), inside.data(),
+                                                      distances.data());
+                    for (std::size_t j = 0; j < found; ++j) visit(block + inside[j], distances[j]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Finds the nearest points that a filter accepts.
+     *
+     * Best-first search: quadrants and points are taken from a queue ordered
+     * by their (least) distance, so points come out nearest first and the
+     * search stops as soon as @p count of them were accepted. Only the
+     * quadrants nearer than the answer are ever opened.
+     *
+     * @param lat Latitude of the center.
+     * @param lon Longitude of the center.
+     * @param count Number of points wanted.
+     * @param maxRadiusMeters Points farther away are not considered.
+     * @param accept Called nearest first with each candidate's index and
+     * distance; returns whether the point counts towards @p count.
+     * @return std::vector<Neighbor> The accepted points, nearest first.
+     */
+    std::vector<Neighbor> nearest(double lat, double lon, std::size_t count, double maxRadiusMeters,
+                                  const std::function<bool(std::size_t, double)>& accept) const;
+
+private:
+    // Points handed to the radius filter at a time
+    static constexpr std::size_t kFilterBlock = 256;
+
+    struct Circle {
+        double lat;
+        double lon;
+        double radiusMeters;
+    };
+
+    // A quadrant of the Hilbert grid: 2^level x 2^level cells from (row,
+    // column), and its directory entries [firstCell, lastCell)
+    struct Quadrant {
+        std::uint32_t row;
+        std::uint32_t column;
+        std::uint32_t level;
+        std::size_t firstCell;
+        std::size_t lastCell;
+    };
+
+    // Runs [first, last) of points in the cells that may hold points of
+    // @p area (and of @p circle, if given), merged where adjacent
+    std::vector<std::pair<std::size_t, std::size_t>> runs_(const tiles::BBox& area, const Circle* circle) const;
+
+    // The aligned quadrant at (@p row, @p column) of side 2^level
+    Quadrant quadrant_(std::uint32_t row, std::uint32_t column, std::uint32_t level) const;
+
+    // Stores the non-empty children of @p quadrant in @p children and returns their number
+    std::size_t split_(const Quadrant& quadrant, std::array<Quadrant, 4>& children) const;
+
+    // First point of directory entry @p c, or the point count past the end
+    std::size_t firstPoint_(std::size_t c) const;
+
+    // Area covered by a quadrant
+    tiles::BBox bounds_(const Quadrant& quadrant) const;
+
+    const std::int32_t* lats_ = nullptr;
+    const std::int32_t* lons_ = nullptr;
+    std::size_t count_ = 0;
+    const grid::Cell* cells_ = nullptr;
+    std::size_t cellCount_ = 0;
+    std::uint32_t cellsPerDegree_ = 1;
+};
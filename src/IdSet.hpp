@@ -0,0 +1,102 @@
+/**
+ * SPDX-FileComment: Internal header for the flat OSM id set
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file IdSet.hpp
+ * @brief Defines IdSet, an open-addressing hash set of 64-bit element keys
+ * used to drop duplicate OSM elements.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Unique key of an OSM element across the node/way/relation id spaces.
+ */
+inline std::uint64_t osmKey(std::string_view type, std::uint64_t id) {
+    std::uint64_t typeBits = type == "node" ? 0 : type == "way" ? 1 : 2;
+    return id << 2 | typeBits;
+}
+
+/**
+ * @brief Insert-only hash set of 64-bit keys.
+ *
+ * Keys are stored in one flat array with linear probing, so an insert is a
+ * hash and usually a single cache line, with no allocation per key. The
+ * table is kept at most half full.
+ */
+class IdSet {
+public:
+    /**
+     * @brief Creates a set sized for @p expected keys.
+     */
+    explicit IdSet(std::size_t expected = 0) {
+        std::size_t capacity = 16;
+        while (capacity < expected * 2) capacity <<= 1;
+        slots_.assign(capacity, kEmpty);
+    }
+
+    /**
+     * @brief Adds a key.
+     *
+     * @return bool true if the key was not in the set yet.
+     */
+    bool insert(std::uint64_t key) {
+        if (key == kEmpty) return !std::exchange(hasEmptyKey_, true);
+        if ((used_ + 1) * 2 > slots_.size()) grow_();
+        if (!place_(slots_, key)) return false;
+        ++used_;
+        return true;
+    }
+
+    /// Number of keys in the set.
+    std::size_t size() const { return used_ + (hasEmptyKey_ ? 1 : 0); }
+
+private:
+    static constexpr std::uint64_t kEmpty = 0;
+
+    // splitmix64 finalizer; OSM ids are dense, so the low bits need mixing
+    static std::uint64_t hash_(std::uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    static bool place_(std::vector<std::uint64_t>& slots, std::uint64_t key) {
+        std::size_t mask = slots.size() - 1;
+        for (std::size_t i = hash_(key) & mask;; i = (i + 1) & mask) {
+            if (slots[i] == key) return false;
+            if (slots[i] == kEmpty) {
+                slots[i] = key;
+                return true;
+            }
+        }
+    }
+
+    void grow_() {
+        std::vector<std::uint64_t> larger(slots_.size() * 2, kEmpty);
+        for (auto key : slots_) {
+            if (key != kEmpty) place_(larger, key);
+        }
+        slots_ = std::move(larger);
+    }
+
+    std::vector<std::uint64_t> slots_;
+    std::size_t used_ = 0;
+    bool hasEmptyKey_ = false;
+};
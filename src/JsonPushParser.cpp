@@ -0,0 +1,288 @@
+/**
+ * SPDX-FileComment: Implementation of the incremental JSON tokenizer
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file JsonPushParser.cpp
+ * @brief Implements the JsonPushParser state machine.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "JsonPushParser.hpp"
+
+#include <format>
+
+namespace {
+
+bool isWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+bool isNumberChar(char c) {
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+JsonPushParser::JsonPushParser(Handler& handler) : handler_(handler) {}
+
+bool JsonPushParser::feed(std::string_view chunk) {
+    std::size_t i = 0;
+    while (i < chunk.size()) {
+        char c = chunk[i];
+
+        switch (state_) {
+        case State::Failed:
+            return false;
+
+        case State::Done:
+            if (!isWhitespace(c)) return fail_("unexpected data after the JSON value");
+            break;
+
+        case State::Value:
+            if (!isWhitespace(c) && !startValue_(c)) return false;
+            break;
+
+        case State::ArrayValueOrEnd:
+            if (isWhitespace(c)) break;
+            if (c == ']') {
+                containers_.pop_back();
+                handler_.endArray();
+                endValue_();
+                break;
+            }
+            if (!startValue_(c)) return false;
+            break;
+
+        case State::ObjectKeyOrEnd:
+        case State::ObjectKey:
+            if (isWhitespace(c)) break;
+            if (c == '}' && state_ == State::ObjectKeyOrEnd) {
+                containers_.pop_back();
+                handler_.endObject();
+                endValue_();
+                break;
+            }
+            if (c != '"') return fail_("expected an object key");
+            token_.clear();
+            stringIsKey_ = true;
+            state_ = State::String;
+            break;
+
+        case State::Colon:
+            if (isWhitespace(c)) break;
+            if (c != ':') return fail_("expected ':'");
+            state_ = State::Value;
+            break;
+
+        case State::CommaOrEnd:
+            if (isWhitespace(c)) break;
+            if (c == ',') {
+                state_ = containers_.back() == '{' ? State::ObjectKey : State::Value;
+            } else if (c == '}' && containers_.back() == '{') {
+                containers_.pop_back();
+                handler_.endObject();
+                endValue_();
+            } else if (c == ']' && containers_.back() == '[') {
+                containers_.pop_back();
+                handler_.endArray();
+                endValue_();
+            } else {
+                return fail_("expected ',' or the end of the container");
+            }
+            break;
+
+        case State::String: {
+            // Copy the run of plain characters in one go
+            std::size_t end = i;
+            while (end < chunk.size() && chunk[end] != '"' && chunk[end] != '\\' &&
+                   static_cast<unsigned char>(chunk[end]) >= 0x20) {
+                ++end;
+            }
+            if (end > i) {
+                if (highSurrogate_) appendCodePoint_(0xFFFD);
+                token_.append(chunk.substr(i, end - i));
+                offset_ += end - i;
+                i = end;
+                continue;
+            }
+            if (c == '\\') {
+                state_ = State::Escape;
+            } else if (c == '"') {
+                if (highSurrogate_) appendCodePoint_(0xFFFD);
+                if (stringIsKey_) {
+                    handler_.key(token_);
+                    state_ = State::Colon;
+                } else {
+                    handler_.string(token_);
+                    endValue_();
+                }
+            } else {
+                return fail_("control character in string");
+            }
+            break;
+        }
+
+        case State::Escape:
+            state_ = State::String;
+            if (c == 'u') {
+                codeUnit_ = 0;
+                codeUnitDigits_ = 0;
+                state_ = State::Unicode;
+                break;
+            }
+            if (highSurrogate_) appendCodePoint_(0xFFFD);
+            switch (c) {
+            case '"': token_ += '"'; break;
+            case '\\': token_ += '\\'; break;
+            case '/': token_ += '/'; break;
+            case 'b': token_ += '\b'; break;
+            case 'f': token_ += '\f'; break;
+            case 'n': token_ += '\n'; break;
+            case 'r': token_ += '\r'; break;
+            case 't': token_ += '\t'; break;
+            default: return fail_("invalid escape sequence");
+            }
+            break;
+
+        case State::Unicode: {
+            int digit = hexValue(c);
+            if (digit < 0) return fail_("invalid \\u escape");
+            codeUnit_ = codeUnit_ << 4 | static_cast<std::uint32_t>(digit);
+            if (++codeUnitDigits_ < 4) break;
+
+            state_ = State::String;
+            if (codeUnit_ >= 0xD800 && codeUnit_ <= 0xDBFF) {
+                if (highSurrogate_) appendCodePoint_(0xFFFD);
+                highSurrogate_ = codeUnit_;
+            } else if (codeUnit_ >= 0xDC00 && codeUnit_ <= 0xDFFF) {
+                if (highSurrogate_) {
+                    appendCodePoint_(0x10000 + ((highSurrogate_ - 0xD800) << 10) + (codeUnit_ - 0xDC00));
+                } else {
+                    appendCodePoint_(0xFFFD);
+                }
+            } else {
+                if (highSurrogate_) appendCodePoint_(0xFFFD);
+                appendCodePoint_(codeUnit_);
+            }
+            break;
+        }
+
+        case State::Number:
+            if (isNumberChar(c)) {
+                token_ += c;
+                break;
+            }
+            handler_.number(token_);
+            endValue_();
+            continue; // the terminating character belongs to the next state
+
+        case State::Literal:
+            if (token_.size() >= literal_.size() || c != literal_[token_.size()]) {
+                return fail_("invalid literal");
+            }
+            token_ += c;
+            if (token_.size() == literal_.size()) {
+                handler_.literal(literal_);
+                endValue_();
+            }
+            break;
+        }
+
+        ++offset_;
+        ++i;
+    }
+    return state_ != State::Failed;
+}
+
+bool JsonPushParser::finish() {
+    if (state_ == State::Number && containers_.empty()) {
+        handler_.number(token_);
+        endValue_();
+    }
+    if (state_ == State::Failed) return false;
+    if (state_ != State::Done) return fail_("unexpected end of input");
+    return true;
+}
+
+bool JsonPushParser::fail_(std::string_view message) {
+    state_ = State::Failed;
+    error_ = std::format("{} at byte {}", message, offset_);
+    return false;
+}
+
+bool JsonPushParser::startValue_(char c) {
+    switch (c) {
+    case '{':
+        containers_.push_back('{');
+        handler_.startObject();
+        state_ = State::ObjectKeyOrEnd;
+        return true;
+    case '[':
+        containers_.push_back('[');
+        handler_.startArray();
+        state_ = State::ArrayValueOrEnd;
+        return true;
+    case '"':
+        token_.clear();
+        stringIsKey_ = false;
+        state_ = State::String;
+        return true;
+    case 't':
+        literal_ = "true";
+        break;
+    case 'f':
+        literal_ = "false";
+        break;
+    case 'n':
+        literal_ = "null";
+        break;
+    default:
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            token_.assign(1, c);
+            state_ = State::Number;
+            return true;
+        }
+        return fail_("unexpected character");
+    }
+
+    token_.assign(1, c);
+    state_ = State::Literal;
+    return true;
+}
+
+void JsonPushParser::endValue_() {
+    state_ = containers_.empty() ? State::Done : State::CommaOrEnd;
+}
+
+void JsonPushParser::appendCodePoint_(std::uint32_t codePoint) {
+    highSurrogate_ = 0;
+    if (codePoint < 0x80) {
+        token_ += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        token_ += static_cast<char>(0xC0 | codePoint >> 6);
+        token_ += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        token_ += static_cast<char>(0xE0 | codePoint >> 12);
+        token_ += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+        token_ += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        token_ += static_cast<char>(0xF0 | codePoint >> 18);
+        token_ += static_cast<char>(0x80 | (codePoint >> 12 & 0x3F));
+        token_ += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+        token_ += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
@@ -0,0 +1,107 @@
+/**
+ * SPDX-FileComment: Internal header for the incremental JSON tokenizer
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file JsonPushParser.hpp
+ * @brief Defines the JsonPushParser class, a SAX-style JSON parser fed with
+ * arbitrary chunks of input.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Push parser for one JSON value, reporting SAX events.
+ *
+ * nlohmann::json::sax_parse() pulls its input and therefore needs the whole
+ * document up front. This parser instead accepts the input in chunks of any
+ * size, e.g. straight from a CURLOPT_WRITEFUNCTION, and keeps only the token
+ * that spans a chunk boundary. Strings are reported unescaped (UTF-8);
+ * numbers are reported as their source text.
+ */
+class JsonPushParser {
+public:
+    /**
+     * @brief Receiver of the parse events.
+     */
+    class Handler {
+    public:
+        virtual ~Handler() = default;
+        virtual void startObject() = 0;
+        virtual void endObject() = 0;
+        virtual void startArray() = 0;
+        virtual void endArray() = 0;
+        virtual void key(std::string_view name) = 0;
+        virtual void string(std::string_view value) = 0;
+        virtual void number(std::string_view text) = 0;
+        /// Called for true, false and null.
+        virtual void literal(std::string_view text) = 0;
+    };
+
+    explicit JsonPushParser(Handler& handler);
+
+    /**
+     * @brief Parses the next chunk of input.
+     *
+     * @param chunk The bytes following the previous chunk.
+     * @return bool false once the input is malformed; see error().
+     */
+    bool feed(std::string_view chunk);
+
+    /**
+     * @brief Signals the end of the input.
+     *
+     * @return bool true if exactly one complete JSON value was parsed.
+     */
+    bool finish();
+
+    /// Description of the first syntax error, empty if there was none.
+    const std::string& error() const { return error_; }
+
+private:
+    enum class State : std::uint8_t {
+        Value,
+        ArrayValueOrEnd,
+        ObjectKeyOrEnd,
+        ObjectKey,
+        Colon,
+        CommaOrEnd,
+        String,
+        Escape,
+        Unicode,
+        Number,
+        Literal,
+        Done,
+        Failed,
+    };
+
+    bool fail_(std::string_view message);
+    bool startValue_(char c);
+    void endValue_();
+    void appendCodePoint_(std::uint32_t codePoint);
+
+    Handler& handler_;
+    State state_ = State::Value;
+    std::vector<char> containers_; // '{' or '[' per open container
+    bool stringIsKey_ = false;
+    std::string token_;
+    std::string_view literal_;
+    std::uint32_t codeUnit_ = 0;
+    int codeUnitDigits_ = 0;
+    std::uint32_t highSurrogate_ = 0;
+    std::size_t offset_ = 0;
+    std::string error_;
+};
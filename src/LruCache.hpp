@@ -0,0 +1,138 @@
+/**
+ * SPDX-FileComment: Internal header for the keyed LRU cache template
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file LruCache.hpp
+ * @brief Defines the LruCache class template, a bounded thread-safe LRU with
+ * per-entry expiry shared by the geocoding and tile caches.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "PoiOsm.hpp"
+
+/**
+ * @brief Bounded LRU cache from string keys to values that expire.
+ *
+ * Each entry carries its own expiry time, given when it is stored; an
+ * expired entry is dropped by the lookup that finds it. When full, storing
+ * a new key evicts the least recently used entry. All methods are safe to
+ * call from several threads.
+ *
+ * @tparam Value Cached value; copied out by lookup().
+ */
+template <typename Value>
+class LruCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Creates a cache.
+     *
+     * @param capacity Maximum number of entries; 0 disables the cache.
+     */
+    explicit LruCache(std::size_t capacity) : capacity_(capacity) {}
+
+    /// Whether the cache holds anything at all.
+    bool enabled() const { return capacity_ != 0; }
+
+    /**
+     * @brief Looks up a key and refreshes its LRU position.
+     *
+     * @param key The cache key.
+     * @return std::optional<Value> The cached value, or std::nullopt on a miss.
+     */
+    std::optional<Value> lookup(const std::string& key) {
+        if (capacity_ == 0) return std::nullopt;
+
+        std::lock_guard lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            ++stats_.misses;
+            return std::nullopt;
+        }
+
+        if (Clock::now() >= it->second->expires) {
+            lru_.erase(it->second);
+            index_.erase(it);
+            ++stats_.expirations;
+            ++stats_.misses;
+            return std::nullopt;
+        }
+
+        lru_.splice(lru_.begin(), lru_, it->second);
+        ++stats_.hits;
+        return it->second->value;
+    }
+
+    /**
+     * @brief Stores a value, evicting the least recently used entry if full.
+     *
+     * @param key The cache key.
+     * @param value The value to cache.
+     * @param ttl Lifetime of the entry.
+     */
+    void store(std::string key, Value value, Clock::duration ttl) {
+        if (capacity_ == 0) return;
+
+        auto expires = Clock::now() + ttl;
+        std::lock_guard lock(mutex_);
+
+        if (auto it = index_.find(key); it != index_.end()) {
+            it->second->value = std::move(value);
+            it->second->expires = expires;
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return;
+        }
+
+        if (lru_.size() >= capacity_) {
+            index_.erase(lru_.back().key);
+            lru_.pop_back();
+            ++stats_.evictions;
+        }
+
+        lru_.push_front(Node{key, std::move(value), expires});
+        index_.emplace(std::move(key), lru_.begin());
+    }
+
+    /**
+     * @brief Returns a snapshot of the hit/miss counters.
+     */
+    PoiCacheStats stats() const {
+        std::lock_guard lock(mutex_);
+        PoiCacheStats snapshot = stats_;
+        snapshot.entries = lru_.size();
+        return snapshot;
+    }
+
+private:
+    struct Node {
+        std::string key;
+        Value value;
+        Clock::time_point expires;
+    };
+
+    std::size_t capacity_;
+
+    mutable std::mutex mutex_;
+    std::list<Node> lru_; // most recently used first
+    std::unordered_map<std::string, typename std::list<Node>::iterator> index_;
+    PoiCacheStats stats_;
+};
@@ -0,0 +1,154 @@
+/**
+ * SPDX-FileComment: Implementation of the streaming Overpass response parser
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file OverpassStream.cpp
+ * @brief Implements OverpassStream on top of JsonPushParser.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "OverpassStream.hpp"
+
+#include <charconv>
+#include <format>
+
+namespace {
+
+template <typename T>
+T parseNumber(std::string_view text) {
+    T value{};
+    std::from_chars(text.data(), text.data() + text.size(), value);
+    return value;
+}
+
+} // namespace
+
+nlohmann::json OsmElement::toJson() const {
+    nlohmann::json element;
+    element["type"] = std::string_view(type);
+    element["id"] = id;
+    if (hasCenter) {
+        element["center"] = {{"lat", lat}, {"lon", lon}};
+    } else {
+        element["lat"] = lat;
+        element["lon"] = lon;
+    }
+
+    nlohmann::json tagObject = nlohmann::json::object();
+    for (const auto& [key, value] : tags) tagObject[std::string(key)] = std::string_view(value);
+    element["tags"] = std::move(tagObject);
+    return element;
+}
+
+OverpassStream::OverpassStream(std::vector<PoiWhitelistEntry> whitelist, Sink sink, TagProjection projection)
+    : matcher_(whitelist), projection_(std::move(projection)), sink_(std::move(sink)), parser_(*this) {}
+
+bool OverpassStream::feed(std::string_view chunk) {
+    if (rejected_) return false;
+
+    // Overpass answers overload and some errors with an HTML page
+    if (!started_) {
+        auto first = chunk.find_first_not_of(" \t\r\n");
+        if (first != std::string_view::npos) {
+            started_ = true;
+            if (chunk[first] == '<') {
+                html_ = true;
+                rejected_ = true;
+                return false;
+            }
+        }
+    }
+
+    bytes_ += chunk.size();
+    if (!parser_.feed(chunk)) rejected_ = true;
+    return !rejected_;
+}
+
+std::expected<void, std::string> OverpassStream::finish() {
+    if (html_) return std::unexpected("Overpass API returned HTML error (server might be busy)");
+    if (!parser_.finish()) return std::unexpected(std::format("JSON parse error: {}", parser_.error()));
+
+    // A runtime error (timeout, memory) comes with a truncated element list
+    if (!remark_.empty() && (!sawElements_ || remark_.find("runtime error") != std::string::npos)) {
+        return std::unexpected(std::format("Overpass API Error: {}", remark_));
+    }
+    if (!sawElements_) return std::unexpected("Invalid Overpass JSON response");
+    return {};
+}
+
+void OverpassStream::startObject() {
+    ++depth_;
+    if (depth_ == 3 && inElements_) {
+        // The previous element is gone once the sink returned; rewind its memory
+        current_.reset();
+        elementArena_.release();
+        current_.emplace(&elementArena_);
+    }
+}
+
+void OverpassStream::endObject() {
+    if (depth_ == 3 && inElements_ && matcher_.matches(current_->tags)) {
+        sink_(*current_);
+    }
+    --depth_;
+}
+
+void OverpassStream::startArray() {
+    ++depth_;
+    if (depth_ == 2 && rootKey_ == "elements") {
+        inElements_ = true;
+        sawElements_ = true;
+    }
+}
+
+void OverpassStream::endArray() {
+    if (depth_ == 2) inElements_ = false;
+    --depth_;
+}
+
+void OverpassStream::key(std::string_view name) {
+    switch (depth_) {
+    case 1: rootKey_.assign(name); break;
+    case 3: elementKey_.assign(name); break;
+    case 4: innerKey_.assign(name); break;
+    default: break;
+    }
+}
+
+void OverpassStream::string(std::string_view value) {
+    if (depth_ == 1 && rootKey_ == "remark") remark_.assign(value);
+    else scalar_(value);
+}
+
+void OverpassStream::number(std::string_view text) {
+    scalar_(text);
+}
+
+void OverpassStream::literal(std::string_view) {}
+
+void OverpassStream::scalar_(std::string_view text) {
+    if (!inElements_) return;
+
+    if (depth_ == 3) {
+        if (elementKey_ == "type") current_->type.assign(text);
+        else if (elementKey_ == "id") current_->id = parseNumber<std::uint64_t>(text);
+        else if (elementKey_ == "lat") current_->lat = parseNumber<double>(text);
+        else if (elementKey_ == "lon") current_->lon = parseNumber<double>(text);
+    } else if (depth_ == 4) {
+        if (elementKey_ == "tags") {
+            if (projection_.keeps(innerKey_)) current_->tags.emplace_back(std::string_view(innerKey_), text);
+            else tagBytesDropped_ += innerKey_.size() + text.size();
+        } else if (elementKey_ == "center") {
+            current_->hasCenter = true;
+            if (innerKey_ == "lat") current_->lat = parseNumber<double>(text);
+            else if (innerKey_ == "lon") current_->lon = parseNumber<double>(text);
+        }
+    }
+}
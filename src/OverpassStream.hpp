@@ -0,0 +1,150 @@
+/**
+ * SPDX-FileComment: Internal header for the streaming Overpass response parser
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file OverpassStream.hpp
+ * @brief Defines OsmElement and the OverpassStream class, which turns an
+ * Overpass JSON response into whitelisted element records while it is
+ * being received.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "JsonPushParser.hpp"
+#include "PoiOsm.hpp"
+#include "TagProjection.hpp"
+#include "Whitelist.hpp"
+
+/**
+ * @brief Compact record of one Overpass element.
+ *
+ * Keeps only what the client uses: type, id, position and tags. Way node
+ * lists, relation members and geometries are skipped while parsing. The
+ * strings are allocated from the memory resource given at construction.
+ */
+struct OsmElement {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    explicit OsmElement(allocator_type alloc = {}) : type(alloc), tags(alloc) {}
+
+    std::pmr::string type;
+    std::uint64_t id = 0;
+    double lat = 0.0;
+    double lon = 0.0;
+    bool hasCenter = false; ///< Position came from "center" (ways, relations).
+    std::pmr::vector<std::pair<std::pmr::string, std::pmr::string>> tags;
+
+    /**
+     * @brief Returns the element in Overpass JSON layout.
+     */
+    nlohmann::json toJson() const;
+};
+
+/**
+ * @brief Incremental parser of Overpass `[out:json]` responses.
+ *
+ * Fed chunk by chunk, e.g. from a CURL write callback. Every element of the
+ * `elements` array is assembled into an OsmElement; elements that match
+ * the whitelist are handed to the sink as soon as their closing brace has
+ * been read, all others are dropped. Memory use is therefore bounded by the
+ * largest single element plus whatever the sink keeps.
+ *
+ * The element being assembled lives in a monotonic arena that is rewound
+ * for every element, so parsing allocates nothing per element unless one
+ * outgrows the arena's inline buffer.
+ */
+class OverpassStream : private JsonPushParser::Handler {
+public:
+    /// Receives each element that matches the whitelist. The element and its
+    /// strings are only valid during the call.
+    using Sink = std::function<void(const OsmElement&)>;
+
+    /**
+     * @brief Creates a parser.
+     *
+     * @param whitelist Elements must match it to reach the sink; empty accepts all.
+     * @param sink Receiver of the matching elements.
+     * @param projection Tags that are not kept are dropped while parsing.
+     */
+    OverpassStream(std::vector<PoiWhitelistEntry> whitelist, Sink sink,
+                   TagProjection projection = TagProjection(std::nullopt, {}));
+
+    /**
+     * @brief Parses the next chunk of the response.
+     *
+     * @param chunk The received bytes.
+     * @return bool false if the response cannot be a valid Overpass answer
+     * (syntax error or HTML error page); the transfer can be aborted.
+     */
+    bool feed(std::string_view chunk);
+
+    /**
+     * @brief Checks the complete response.
+     *
+     * @return std::expected<void, std::string> Empty if all elements were
+     * delivered, otherwise the error (parse error, HTML page, Overpass
+     * runtime error remark, missing elements array).
+     */
+    std::expected<void, std::string> finish();
+
+    /// Response bytes fed so far.
+    std::size_t bytes() const { return bytes_; }
+
+    /// Bytes of tag keys and values dropped by the projection so far.
+    std::size_t tagBytesDropped() const { return tagBytesDropped_; }
+
+private:
+    void startObject() override;
+    void endObject() override;
+    void startArray() override;
+    void endArray() override;
+    void key(std::string_view name) override;
+    void string(std::string_view value) override;
+    void number(std::string_view text) override;
+    void literal(std::string_view text) override;
+
+    void scalar_(std::string_view text);
+
+    whitelist::Matcher matcher_;
+    TagProjection projection_;
+    Sink sink_;
+    JsonPushParser parser_;
+
+    std::size_t bytes_ = 0;
+    std::size_t tagBytesDropped_ = 0;
+    bool started_ = false;   // a non-whitespace byte has been seen
+    bool html_ = false;
+    bool rejected_ = false;
+    int depth_ = 0;          // nesting depth of the current event
+    bool inElements_ = false;
+    bool sawElements_ = false;
+    std::string rootKey_;    // last key of the root object
+    std::string elementKey_; // last key of the current element
+    std::string innerKey_;   // last key inside "center" or "tags"
+    std::string remark_;
+
+    std::array<std::byte, 4096> elementBuffer_;
+    std::pmr::monotonic_buffer_resource elementArena_{elementBuffer_.data(), elementBuffer_.size()};
+    std::optional<OsmElement> current_;
+};
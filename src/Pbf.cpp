@@ -0,0 +1,450 @@
+/**
+ * SPDX-FileComment: Implementation of the OpenStreetMap PBF reader
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file Pbf.cpp
+ * @brief Implements protobuf wire decoding, blob inflation and element
+ * decoding for `.osm.pbf` files.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "Pbf.hpp"
+
+#include <array>
+#include <format>
+
+#include <zlib.h>
+
+namespace pbf {
+
+namespace {
+
+// Limits from the PBF specification
+constexpr std::uint32_t kMaxBlobHeaderSize = 64 * 1024;
+constexpr std::uint64_t kMaxBlobSize = 32 * 1024 * 1024;
+
+constexpr double kNanoDegrees = 1e-9;
+
+std::uint64_t littleEndian(std::string_view data, std::size_t size) {
+    std::uint64_t value = 0;
+    for (std::size_t i = size; i-- > 0;) value = value << 8 | static_cast<unsigned char>(data[i]);
+    return value;
+}
+
+// Packed repeated integers of a length-delimited field
+class Packed {
+public:
+    explicit Packed(std::string_view data) : data_(data) {}
+
+    bool empty() const { return data_.empty(); }
+    std::optional<std::uint64_t> next() { return ProtoReader::readVarint(data_); }
+
+private:
+    std::string_view data_;
+};
+
+// Appends the values of a repeated uint32 field, packed or not
+void appendIndices(ProtoReader& reader, std::vector<std::uint32_t>& out) {
+    if (reader.wireType() != 2) {
+        out.push_back(static_cast<std::uint32_t>(reader.varint()));
+        return;
+    }
+    Packed packed(reader.bytes());
+    while (auto value = packed.next()) out.push_back(static_cast<std::uint32_t>(*value));
+}
+
+// Appends the values of a packed, delta-coded sint64 field
+bool appendDeltas(std::string_view data, std::vector<std::int64_t>& out) {
+    Packed packed(data);
+    std::int64_t value = 0;
+    while (!packed.empty()) {
+        auto delta = packed.next();
+        if (!delta) return false;
+        value += ProtoReader::zigzag(*delta);
+        out.push_back(value);
+    }
+    return true;
+}
+
+// Coordinate and string context of a PrimitiveBlock
+struct BlockContext {
+    std::vector<std::string_view> strings;
+    std::int64_t granularity = 100;
+    std::int64_t latOffset = 0;
+    std::int64_t lonOffset = 0;
+
+    double lat(std::int64_t value) const { return kNanoDegrees * static_cast<double>(latOffset + granularity * value); }
+    double lon(std::int64_t value) const { return kNanoDegrees * static_cast<double>(lonOffset + granularity * value); }
+
+    std::optional<std::string_view> string(std::uint64_t index) const {
+        if (index >= strings.size()) return std::nullopt;
+        return strings[index];
+    }
+
+    // Resolves parallel key and value index lists
+    bool tags(const std::vector<std::uint32_t>& keys, const std::vector<std::uint32_t>& values, Tags& out) const {
+        if (keys.size() != values.size()) return false;
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            auto key = string(keys[i]);
+            auto value = string(values[i]);
+            if (!key || !value) return false;
+            out.emplace_back(*key, *value);
+        }
+        return true;
+    }
+};
+
+using NodeSink = std::function<void(const Node&)>;
+
+std::expected<void, std::string> decodeNode(std::string_view message, const BlockContext& context, Node& node,
+                                            const NodeSink& sink) {
+    std::vector<std::uint32_t> keys;
+    std::vector<std::uint32_t> values;
+    node.id = 0;
+    node.tags.clear();
+
+    ProtoReader reader(message);
+    std::int64_t lat = 0;
+    std::int64_t lon = 0;
+    while (reader.next()) {
+        switch (reader.field()) {
+        case 1: node.id = reader.svarint(); break;
+        case 2: appendIndices(reader, keys); break;
+        case 3: appendIndices(reader, values); break;
+        case 8: lat = reader.svarint(); break;
+        case 9: lon = reader.svarint(); break;
+        default: break;
+        }
+    }
+    if (!reader.ok() || !context.tags(keys, values, node.tags)) return std::unexpected("Malformed PBF node");
+
+    node.lat = context.lat(lat);
+    node.lon = context.lon(lon);
+    sink(node);
+    return {};
+}
+
+std::expected<void, std::string> decodeWay(std::string_view message, const BlockContext& context, Way& way,
+                                           const std::function<void(const Way&)>& sink) {
+    std::vector<std::uint32_t> keys;
+    std::vector<std::uint32_t> values;
+    way.id = 0;
+    way.tags.clear();
+    way.refs.clear();
+
+    ProtoReader reader(message);
+    bool refsOk = true;
+    while (reader.next()) {
+        switch (reader.field()) {
+        case 1: way.id = static_cast<std::int64_t>(reader.varint()); break;
+        case 2: appendIndices(reader, keys); break;
+        case 3: appendIndices(reader, values); break;
+        case 8: refsOk = refsOk && appendDeltas(reader.bytes(), way.refs); break;
+        default: break;
+        }
+    }
+    if (!reader.ok() || !refsOk || !context.tags(keys, values, way.tags)) return std::unexpected("Malformed PBF way");
+
+    sink(way);
+    return {};
+}
+
+std::expected<void, std::string> decodeRelation(std::string_view message, const BlockContext& context,
+                                                Relation& relation,
+                                                const std::function<void(const Relation&)>& sink) {
+    std::vector<std::uint32_t> keys;
+    std::vector<std::uint32_t> values;
+    std::vector<std::int64_t> ids;
+    std::vector<std::uint32_t> types;
+    relation.id = 0;
+    relation.tags.clear();
+    relation.members.clear();
+
+    ProtoReader reader(message);
+    bool idsOk = true;
+    while (reader.next()) {
+        switch (reader.field()) {
+        case 1: relation.id = static_cast<std::int64_t>(reader.varint()); break;
+        case 2: appendIndices(reader, keys); break;
+        case 3: appendIndices(reader, values); break;
+        case 9: idsOk = idsOk && appendDeltas(reader.bytes(), ids); break;
+        case 10: appendIndices(reader, types); break;
+        default: break;
+        }
+    }
+    if (!reader.ok() || !idsOk || ids.size() != types.size() || !context.tags(keys, values, relation.tags)) {
+        return std::unexpected("Malformed PBF relation");
+    }
+
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        if (types[i] > 2) return std::unexpected("Malformed PBF relation");
+        relation.members.emplace_back(static_cast<MemberType>(types[i]), ids[i]);
+    }
+    sink(relation);
+    return {};
+}
+
+std::expected<void, std::string> decodeDenseNodes(std::string_view message, const BlockContext& context, Node& node,
+                                                  const NodeSink& sink) {
+    std::string_view ids, lats, lons, keysVals;
+    ProtoReader reader(message);
+    while (reader.next()) {
+        switch (reader.field()) {
+        case 1: ids = reader.bytes(); break;
+        case 8: lats = reader.bytes(); break;
+        case 9: lons = reader.bytes(); break;
+        case 10: keysVals = reader.bytes(); break;
+        default: break;
+        }
+    }
+    if (!reader.ok()) return std::unexpected("Malformed PBF dense nodes");
+
+    // Ids and coordinates are delta coded; tags are (key, value) string
+    // indices with a 0 closing each node
+    Packed idStream(ids), latStream(lats), lonStream(lons), tagStream(keysVals);
+    std::int64_t id = 0, lat = 0, lon = 0;
+    while (!idStream.empty()) {
+        auto idDelta = idStream.next();
+        auto latDelta = latStream.next();
+        auto lonDelta = lonStream.next();
+        if (!idDelta || !latDelta || !lonDelta) return std::unexpected("Malformed PBF dense nodes");
+        id += ProtoReader::zigzag(*idDelta);
+        lat += ProtoReader::zigzag(*latDelta);
+        lon += ProtoReader::zigzag(*lonDelta);
+
+        node.id = id;
+        node.lat = context.lat(lat);
+        node.lon = context.lon(lon);
+        node.tags.clear();
+        while (!tagStream.empty()) {
+            auto keyIndex = tagStream.next();
+            if (!keyIndex) return std::unexpected("Malformed PBF dense node tags");
+            if (*keyIndex == 0) break;
+
+            auto valueIndex = tagStream.next();
+            auto key = context.string(*keyIndex);
+            auto value = valueIndex ? context.string(*valueIndex) : std::nullopt;
+            if (!key || !value) return std::unexpected("PBF node references a missing string");
+            node.tags.emplace_back(*key, *value);
+        }
+        sink(node);
+    }
+    return {};
+}
+
+} // namespace
+
+std::optional<std::uint64_t> ProtoReader::readVarint(std::string_view& data) {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < data.size() && i < 10; ++i) {
+        auto byte = static_cast<unsigned char>(data[i]);
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << (7 * i);
+        if ((byte & 0x80) == 0) {
+            data.remove_prefix(i + 1);
+            return value;
+        }
+    }
+    return std::nullopt;
+}
+
+bool ProtoReader::next() {
+    if (!ok_ || data_.empty()) return false;
+
+    auto key = readVarint(data_);
+    if (!key) return ok_ = false;
+    field_ = static_cast<std::uint32_t>(*key >> 3);
+    wireType_ = static_cast<int>(*key & 7);
+
+    switch (wireType_) {
+    case 0: {
+        auto value = readVarint(data_);
+        if (!value) return ok_ = false;
+        value_ = *value;
+        return true;
+    }
+    case 1:
+    case 5: {
+        std::size_t size = wireType_ == 1 ? 8 : 4;
+        if (data_.size() < size) return ok_ = false;
+        value_ = littleEndian(data_, size);
+        data_.remove_prefix(size);
+        return true;
+    }
+    case 2: {
+        auto length = readVarint(data_);
+        if (!length || *length > data_.size()) return ok_ = false;
+        bytes_ = data_.substr(0, *length);
+        data_.remove_prefix(*length);
+        return true;
+    }
+    default:
+        return ok_ = false;
+    }
+}
+
+std::expected<PbfFile, std::string> PbfFile::open(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return std::unexpected(std::format("Cannot open PBF file {}", path));
+    return PbfFile(std::move(in));
+}
+
+std::expected<std::optional<RawBlob>, std::string> PbfFile::next() {
+    auto offset = static_cast<std::uint64_t>(in_.tellg());
+    std::array<unsigned char, 4> sizeBytes;
+    in_.read(reinterpret_cast<char*>(sizeBytes.data()), sizeBytes.size());
+    if (in_.gcount() == 0 && in_.eof()) return std::nullopt;
+    if (in_.gcount() != static_cast<std::streamsize>(sizeBytes.size())) return std::unexpected("Truncated PBF file");
+
+    std::uint32_t headerSize = std::uint32_t{sizeBytes[0]} << 24 | std::uint32_t{sizeBytes[1]} << 16 |
+                               std::uint32_t{sizeBytes[2]} << 8 | sizeBytes[3];
+    if (headerSize > kMaxBlobHeaderSize) return std::unexpected("PBF blob header too large");
+
+    std::string header(headerSize, '\0');
+    if (!in_.read(header.data(), headerSize)) return std::unexpected("Truncated PBF file");
+
+    RawBlob raw;
+    raw.offset = offset;
+    std::uint64_t dataSize = 0;
+    ProtoReader reader(header);
+    while (reader.next()) {
+        if (reader.field() == 1) raw.type = reader.bytes();
+        else if (reader.field() == 3) dataSize = reader.varint();
+    }
+    if (!reader.ok() || raw.type.empty()) return std::unexpected("Malformed PBF blob header");
+    if (dataSize > kMaxBlobSize) return std::unexpected("PBF blob too large");
+
+    raw.blob.resize(dataSize);
+    if (!in_.read(raw.blob.data(), static_cast<std::streamsize>(dataSize))) return std::unexpected("Truncated PBF file");
+    return raw;
+}
+
+std::expected<RawBlob, std::string> PbfFile::readAt(std::uint64_t offset) {
+    in_.clear();
+    if (!in_.seekg(static_cast<std::streamoff>(offset))) return std::unexpected("Cannot seek in PBF file");
+
+    auto blob = next();
+    if (!blob) return std::unexpected(blob.error());
+    if (!*blob) return std::unexpected("Truncated PBF file");
+    return std::move(**blob);
+}
+
+std::expected<std::string, std::string> blobData(std::string_view blob) {
+    std::string_view raw, zlibData;
+    std::uint64_t rawSize = 0;
+    bool otherCompression = false;
+
+    ProtoReader reader(blob);
+    while (reader.next()) {
+        switch (reader.field()) {
+        case 1: raw = reader.bytes(); break;
+        case 2: rawSize = reader.varint(); break;
+        case 3: zlibData = reader.bytes(); break;
+        case 4: // lzma
+        case 6: // lz4
+        case 7: // zstd
+            otherCompression = true;
+            break;
+        default: break;
+        }
+    }
+    if (!reader.ok()) return std::unexpected("Malformed PBF blob");
+    if (!raw.empty()) return std::string(raw);
+    if (otherCompression) return std::unexpected("PBF blob uses an unsupported compression (only zlib is supported)");
+    if (rawSize > kMaxBlobSize) return std::unexpected("PBF blob too large");
+
+    std::string data(rawSize, '\0');
+    uLongf size = static_cast<uLongf>(rawSize);
+    int status = ::uncompress(reinterpret_cast<Bytef*>(data.data()), &size,
+                              reinterpret_cast<const Bytef*>(zlibData.data()), static_cast<uLong>(zlibData.size()));
+    if (status != Z_OK || size != rawSize) return std::unexpected("Corrupt zlib data in PBF blob");
+    return data;
+}
+
+std::expected<std::optional<Bounds>, std::string> decodeHeader(std::string_view block) {
+    std::optional<Bounds> bounds;
+
+    ProtoReader reader(block);
+    while (reader.next()) {
+        if (reader.field() == 1) {
+            // HeaderBBox in nanodegrees: left, right, top, bottom
+            std::int64_t box[4] = {};
+            ProtoReader bbox(reader.bytes());
+            while (bbox.next()) {
+                if (bbox.field() >= 1 && bbox.field() <= 4) box[bbox.field() - 1] = bbox.svarint();
+            }
+            if (!bbox.ok()) return std::unexpected("Malformed PBF header bounding box");
+            bounds = Bounds{kNanoDegrees * static_cast<double>(box[3]), kNanoDegrees * static_cast<double>(box[0]),
+                            kNanoDegrees * static_cast<double>(box[2]), kNanoDegrees * static_cast<double>(box[1])};
+        } else if (reader.field() == 4) {
+            auto feature = reader.bytes();
+            if (feature != "OsmSchema-V0.6" && feature != "DenseNodes") {
+                return std::unexpected(std::format("PBF file requires unsupported feature {}", feature));
+            }
+        }
+    }
+    if (!reader.ok()) return std::unexpected("Malformed PBF header");
+    return bounds;
+}
+
+std::expected<void, std::string> decodeBlock(std::string_view block, const BlockHandler& handler) {
+    // Groups may precede the coordinate settings, so they are decoded last
+    BlockContext context;
+    std::vector<std::string_view> groups;
+
+    ProtoReader reader(block);
+    while (reader.next()) {
+        switch (reader.field()) {
+        case 1: {
+            ProtoReader table(reader.bytes());
+            while (table.next()) {
+                if (table.field() == 1) context.strings.push_back(table.bytes());
+            }
+            if (!table.ok()) return std::unexpected("Malformed PBF string table");
+            break;
+        }
+        case 2: groups.push_back(reader.bytes()); break;
+        case 17: context.granularity = static_cast<std::int64_t>(reader.varint()); break;
+        case 19: context.latOffset = static_cast<std::int64_t>(reader.varint()); break;
+        case 20: context.lonOffset = static_cast<std::int64_t>(reader.varint()); break;
+        default: break;
+        }
+    }
+    if (!reader.ok()) return std::unexpected("Malformed PBF primitive block");
+
+    Node node;
+    Way way;
+    Relation relation;
+    for (auto group : groups) {
+        ProtoReader groupReader(group);
+        while (groupReader.next()) {
+            std::expected<void, std::string> status;
+            switch (groupReader.field()) {
+            case 1:
+                if (handler.node) status = decodeNode(groupReader.bytes(), context, node, handler.node);
+                break;
+            case 2:
+                if (handler.node) status = decodeDenseNodes(groupReader.bytes(), context, node, handler.node);
+                break;
+            case 3:
+                if (handler.way) status = decodeWay(groupReader.bytes(), context, way, handler.way);
+                break;
+            case 4:
+                if (handler.relation) status = decodeRelation(groupReader.bytes(), context, relation, handler.relation);
+                break;
+            default: break;
+            }
+            if (!status) return status;
+        }
+        if (!groupReader.ok()) return std::unexpected("Malformed PBF primitive group");
+    }
+    return {};
+}
+
+} // namespace pbf
@@ -0,0 +1,208 @@
+/**
+ * SPDX-FileComment: Internal header for reading OpenStreetMap PBF files
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file Pbf.hpp
+ * @brief Declares a minimal reader for `.osm.pbf` extracts: protobuf wire
+ * format decoding, zlib blobs and the elements of primitive blocks.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace pbf {
+
+/**
+ * @brief Cursor over the fields of one protobuf message.
+ *
+ * Only the wire format is decoded; the caller knows the schema. Every read
+ * is bounds-checked, and a malformed message ends the iteration with
+ * ok() == false.
+ */
+class ProtoReader {
+public:
+    explicit ProtoReader(std::string_view data) : data_(data) {}
+
+    /// Advances to the next field; false at the end of the message or on malformed input.
+    bool next();
+
+    /// Number of the current field.
+    std::uint32_t field() const { return field_; }
+
+    /// Wire type of the current field (0 varint, 1 64-bit, 2 length-delimited, 5 32-bit).
+    int wireType() const { return wireType_; }
+
+    /// Value of the current varint field.
+    std::uint64_t varint() { return value_; }
+
+    /// Value of the current zigzag-encoded (sint32/sint64) varint field.
+    std::int64_t svarint() { return zigzag(value_); }
+
+    /// Payload of the current length-delimited field (bytes, string, message or packed array).
+    std::string_view bytes() const { return bytes_; }
+
+    /// Whether the message was well formed up to the current position.
+    bool ok() const { return ok_; }
+
+    /// Decodes a zigzag-encoded integer.
+    static std::int64_t zigzag(std::uint64_t v) {
+        return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+    }
+
+    /**
+     * @brief Reads one varint from the front of @p data and removes it.
+     *
+     * @return std::optional<std::uint64_t> The value, or std::nullopt if @p data ends inside it.
+     */
+    static std::optional<std::uint64_t> readVarint(std::string_view& data);
+
+private:
+    std::string_view data_;
+    std::uint32_t field_ = 0;
+    int wireType_ = 0;
+    std::uint64_t value_ = 0;
+    std::string_view bytes_;
+    bool ok_ = true;
+};
+
+/// Area an extract covers, in degrees.
+struct Bounds {
+    double south;
+    double west;
+    double north;
+    double east;
+};
+
+/// One blob of a PBF file as stored, before decompression.
+struct RawBlob {
+    std::uint64_t offset = 0; ///< Position of the blob in the file, for PbfFile::readAt().
+    std::string type;         ///< "OSMHeader" or "OSMData".
+    std::string blob;         ///< Serialized Blob message.
+};
+
+/**
+ * @brief Sequential reader of the blobs of a PBF file.
+ */
+class PbfFile {
+public:
+    /**
+     * @brief Opens a PBF file.
+     *
+     * @param path Path of the `.osm.pbf` file.
+     * @return std::expected<PbfFile, std::string> The reader or an error message.
+     */
+    static std::expected<PbfFile, std::string> open(const std::string& path);
+
+    /**
+     * @brief Reads the next blob.
+     *
+     * @return std::expected<std::optional<RawBlob>, std::string> The blob,
+     * std::nullopt at the end of the file, or an error message.
+     */
+    std::expected<std::optional<RawBlob>, std::string> next();
+
+    /**
+     * @brief Reads the blob at @p offset, as reported by an earlier next().
+     *
+     * Sequential reading continues after that blob.
+     *
+     * @return std::expected<RawBlob, std::string> The blob or an error message.
+     */
+    std::expected<RawBlob, std::string> readAt(std::uint64_t offset);
+
+private:
+    explicit PbfFile(std::ifstream in) : in_(std::move(in)) {}
+
+    std::ifstream in_;
+};
+
+/**
+ * @brief Returns the uncompressed content of a blob (raw or zlib).
+ *
+ * @param blob Serialized Blob message.
+ * @return std::expected<std::string, std::string> The block or an error message.
+ */
+std::expected<std::string, std::string> blobData(std::string_view blob);
+
+/**
+ * @brief Decodes a HeaderBlock.
+ *
+ * Fails if the file requires a feature this reader does not implement,
+ * e.g. historical information.
+ *
+ * @param block Uncompressed HeaderBlock.
+ * @return std::expected<std::optional<Bounds>, std::string> The bounding box
+ * of the extract if the header has one, or an error message.
+ */
+std::expected<std::optional<Bounds>, std::string> decodeHeader(std::string_view block);
+
+/// Tags of an element. The strings point into the block.
+using Tags = std::vector<std::pair<std::string_view, std::string_view>>;
+
+/// A node of a primitive block.
+struct Node {
+    std::int64_t id = 0;
+    double lat = 0.0;
+    double lon = 0.0;
+    Tags tags;
+};
+
+/// A way of a primitive block, with the ids of its nodes.
+struct Way {
+    std::int64_t id = 0;
+    Tags tags;
+    std::vector<std::int64_t> refs;
+};
+
+/// Kind of a relation member, as encoded in the file.
+enum class MemberType { Node = 0, Way = 1, Relation = 2 };
+
+/// A relation of a primitive block, with its members (roles are skipped).
+struct Relation {
+    std::int64_t id = 0;
+    Tags tags;
+    std::vector<std::pair<MemberType, std::int64_t>> members;
+};
+
+/**
+ * @brief Receivers of the elements of a block.
+ *
+ * An element is only valid during the call. Kinds without a receiver are
+ * skipped without being decoded.
+ */
+struct BlockHandler {
+    std::function<void(const Node&)> node;
+    std::function<void(const Way&)> way;
+    std::function<void(const Relation&)> relation;
+};
+
+/**
+ * @brief Decodes the elements of a PrimitiveBlock.
+ *
+ * Nodes may be plain or dense; changesets are skipped.
+ *
+ * @param block Uncompressed PrimitiveBlock.
+ * @param handler Receivers of the elements, tagged or not.
+ * @return std::expected<void, std::string> Empty on success, or an error message.
+ */
+std::expected<void, std::string> decodeBlock(std::string_view block, const BlockHandler& handler);
+
+} // namespace pbf
@@ -15,86 +15,431 @@
  */
 
 #include "PoiOsm.hpp"
+#include "AsyncEngine.hpp"
+#include "CurlPool.hpp"
+#include "GeocodeCache.hpp"
+#include "Geo.hpp"
+#include "GeocodeStore.hpp"
+#include "IdSet.hpp"
+#include "OverpassStream.hpp"
+#include "PoiResultBuilder.hpp"
+#include "PoiSelector.hpp"
+#include "PoiStore.hpp"
+#include "PoiStoreBuilder.hpp"
+#include "RadiusFilter.hpp"
+#include "ReactorFetch.hpp"
+#include "SpatialCache.hpp"
+#include "TagProjection.hpp"
+#include "TileCache.hpp"
+#include "Tiles.hpp"
+#include "Whitelist.hpp"
 
-#include <curl/curl.h>
+#include <algorithm>
+#include <charconv>
+#include <coroutine>
 #include <format>
 #include <iostream>
 #include <chrono>
+#include <cmath>
 #include <ctime>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace {
 
-// Helper for writing curl response to string
-size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
-    ((std::string*)userp)->append((char*)contents, size * nmemb);
-    return size * nmemb;
+// Successful lookups and definite "no result" answers are worth caching;
+// transport and parse errors are not.
+bool isCacheableGeocode(const GeocodeCache::Result& result) {
+    return result || result.error() == GeocodeCache::kNoResult;
 }
 
-// Simple RAII wrapper for CURL handle
-struct CurlHandle {
-    CURL* curl;
-    CurlHandle() : curl(curl_easy_init()) {}
-    ~CurlHandle() { if (curl) curl_easy_cleanup(curl); }
-    operator CURL*() const { return curl; }
+// Get current ISO8601 time
+std::string currentIsoTime() {
+    auto now = std::chrono::system_clock::now();
+    std::time_t now_c = std::chrono::system_clock::to_time_t(now);
+    std::tm now_tm = *std::gmtime(&now_c);
+    char buf[30];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &now_tm);
+    return std::string(buf);
+}
+
+// Query input block for address based queries
+nlohmann::json addressInput(const std::string& address) {
+    nlohmann::json input;
+    input["address"] = address;
+    input["lat"] = nullptr;
+    input["lon"] = nullptr;
+    return input;
+}
+
+// Query input block for coordinate based queries
+nlohmann::json coordinatesInput(double lat, double lon) {
+    nlohmann::json input;
+    input["address"] = nullptr;
+    input["lat"] = lat;
+    input["lon"] = lon;
+    return input;
+}
+
+// Whether PoiOsmClientOptions::tags asks for no tags at all, so `out skel` suffices
+bool dropsAllTags(const std::optional<std::vector<std::string>>& tags) {
+    return tags && tags->empty();
+}
+
+// Whitelist the client applies to received elements. An `out skel` response
+// has no tags to match, and Overpass has applied the whitelist already.
+std::vector<PoiWhitelistEntry> clientWhitelist(const std::vector<PoiWhitelistEntry>& whitelist,
+                                               const std::optional<std::vector<std::string>>& tags) {
+    return dropsAllTags(tags) ? std::vector<PoiWhitelistEntry>{} : whitelist;
+}
+
+// Collects the whitelisted elements of an Overpass response while it is
+// received, keeping only the projected tags
+class ElementCollector {
+public:
+    ElementCollector(const std::vector<PoiWhitelistEntry>& whitelist,
+                     const std::optional<std::vector<std::string>>& tags)
+        : stream_(clientWhitelist(whitelist, tags),
+                  [this](const OsmElement& element) { elements_.push_back(element.toJson()); },
+                  TagProjection(tags, whitelist)) {}
+
+    // Hands the elements to @p sink instead of collecting them
+    ElementCollector(const std::vector<PoiWhitelistEntry>& whitelist,
+                     const std::optional<std::vector<std::string>>& tags, OverpassStream::Sink sink)
+        : stream_(clientWhitelist(whitelist, tags), std::move(sink), TagProjection(tags, whitelist)) {}
+
+    ElementCollector(const ElementCollector&) = delete;
+    ElementCollector& operator=(const ElementCollector&) = delete;
+
+    // Write callback target; the collector must outlive the transfer
+    CurlPool::ChunkSink sink() {
+        return [this](std::string_view chunk) {
+            if (!stream_.feed(chunk)) rejected_ = true;
+            return !rejected_;
+        };
+    }
+
+    std::size_t bytes() const { return stream_.bytes(); }
+    std::size_t tagBytesDropped() const { return stream_.tagBytesDropped(); }
+
+    // Combines the outcome of the transfer with the parser's verdict. When the
+    // parser aborted the transfer its own error explains the failure better,
+    // unless the server had already answered with an HTTP error status.
+    template <typename T>
+    std::expected<nlohmann::json, std::string> finish(const std::expected<T, std::string>& transfer) {
+        if (!transfer && (!rejected_ || transfer.error().starts_with("HTTP Error"))) {
+            return std::unexpected(transfer.error());
+        }
+        if (auto status = stream_.finish(); !status) return std::unexpected(status.error());
+        return std::move(elements_);
+    }
+
+private:
+    nlohmann::json elements_ = nlohmann::json::array();
+    OverpassStream stream_;
+    bool rejected_ = false;
 };
 
-// URL Encoder helper
-std::string urlEncode(CURL* curl, const std::string& value) {
-    char* output = curl_easy_escape(curl, value.c_str(), static_cast<int>(value.length()));
-    if (output) {
-        std::string result(output);
-        curl_free(output);
-        return result;
+// Whether elements of @p type become POIs; ways and relations only when queried with nwr
+bool isPoiType(std::string_view type, bool waysAndRelations) {
+    return type == "node" || (waysAndRelations && (type == "way" || type == "relation"));
+}
+
+// Distance as reported in `distance_m`
+double roundedMeters(double meters) {
+    return std::round(meters * 10.0) / 10.0;
+}
+
+// POI object of the result JSON for an element @p distance meters from the query center
+nlohmann::json poiJson(const OsmElement& element, double distance) {
+    nlohmann::json poi;
+    poi["type"] = std::string_view(element.type);
+    poi["id"] = element.id;
+    poi["lat"] = element.lat;
+    poi["lon"] = element.lon;
+    poi["distance_m"] = roundedMeters(distance);
+    poi["name"] = nullptr;
+
+    nlohmann::json tags = nlohmann::json::object();
+    for (const auto& [key, value] : element.tags) {
+        if (key == "name") poi["name"] = std::string_view(value);
+        tags[std::string(key)] = std::string_view(value);
     }
-    return "";
+    poi["tags"] = std::move(tags);
+    return poi;
 }
 
-// Perform HTTP GET or POST
-std::expected<std::string, std::string> performRequest(const std::string& url, const std::string& postData = "") {
-    CurlHandle handle;
-    if (!handle.curl) return std::unexpected("Failed to initialize CURL");
+// Position of an element: nodes carry lat/lon, ways and relations a center
+std::pair<double, double> elementPosition(const nlohmann::json& element) {
+    if (auto center = element.find("center"); center != element.end()) {
+        return {center->value("lat", 0.0), center->value("lon", 0.0)};
+    }
+    return {element.value("lat", 0.0), element.value("lon", 0.0)};
+}
 
-    std::string readBuffer;
-    curl_easy_setopt(handle.curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(handle.curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(handle.curl, CURLOPT_WRITEDATA, &readBuffer);
-    curl_easy_setopt(handle.curl, CURLOPT_USERAGENT, "get_poi-osm/1.0 (https://github.com/Zheng-Bote/get_poi-osm)");
-    curl_easy_setopt(handle.curl, CURLOPT_REFERER, "https://github.com/Zheng-Bote/get_poi-osm");
-    
-    // Follow redirects
-    curl_easy_setopt(handle.curl, CURLOPT_FOLLOWLOCATION, 1L);
+// Overpass failures that a query over a smaller area is likely to avoid
+bool isSplittableError(const std::string& error) {
+    return error.find("timed out") != std::string::npos ||
+           error.find("out of memory") != std::string::npos ||
+           error.find("HTML error") != std::string::npos ||
+           error == "HTTP Error: 504";
+}
 
-    if (!postData.empty()) {
-        curl_easy_setopt(handle.curl, CURLOPT_POSTFIELDS, postData.c_str());
+// Overpass area filter of a circle
+std::string aroundFilter(double lat, double lon, int radiusMeters) {
+    return std::format("(around:{},{:.6f},{:.6f})", radiusMeters, lat, lon);
+}
+
+// Overpass area filter of a bounding box
+std::string bboxFilter(const tiles::BBox& box) {
+    return std::format("({:.6f},{:.6f},{:.6f},{:.6f})", box.south, box.west, box.north, box.east);
+}
+
+// Overpass QL string literal
+std::string qlString(std::string_view text) {
+    std::string out = "\"";
+    for (char ch : text) {
+        if (ch == '"' || ch == '\\') out += '\\';
+        out += ch;
     }
+    return out + '"';
+}
 
-    CURLcode res = curl_easy_perform(handle.curl);
-    if (res != CURLE_OK) {
-        return std::unexpected(std::format("CURL request failed: {}", curl_easy_strerror(res)));
+// Tag filters of a whitelist, one per key: entries sharing a key become a
+// single anchored regex alternation, and a key without value absorbs the rest
+std::vector<std::string> tagFilters(const std::vector<PoiWhitelistEntry>& whitelist) {
+    std::vector<std::string> keys;
+    std::unordered_map<std::string, std::vector<std::string>> values;
+    std::unordered_set<std::string> anyValue;
+    for (const auto& w : whitelist) {
+        auto [it, added] = values.try_emplace(w.key);
+        if (added) keys.push_back(w.key);
+        if (w.value.empty()) anyValue.insert(w.key);
+        else if (std::ranges::find(it->second, w.value) == it->second.end()) it->second.push_back(w.value);
     }
 
-    long response_code;
-    curl_easy_getinfo(handle.curl, CURLINFO_RESPONSE_CODE, &response_code);
-    if (response_code >= 400) {
-        return std::unexpected(std::format("HTTP Error: {}", response_code));
+    std::vector<std::string> filters;
+    filters.reserve(keys.size());
+    for (const auto& key : keys) {
+        const auto& accepted = values[key];
+        if (anyValue.contains(key)) {
+            filters.push_back(std::format("[{}]", qlString(key)));
+        } else if (accepted.size() == 1) {
+            filters.push_back(std::format("[{}={}]", qlString(key), qlString(accepted.front())));
+        } else {
+            std::string pattern = "^(";
+            for (const auto& value : accepted) {
+                if (pattern.size() > 2) pattern += '|';
+                for (char ch : value) {
+                    if (std::string_view("\\^$.|?*+()[]{}").find(ch) != std::string_view::npos) pattern += '\\';
+                    pattern += ch;
+                }
+            }
+            pattern += ")$";
+            filters.push_back(std::format("[{}~{}]", qlString(key), qlString(pattern)));
+        }
     }
+    return filters;
+}
 
-    return readBuffer;
+// Whitelist entries without repetitions, in their original order
+std::vector<PoiWhitelistEntry> distinctEntries(const std::vector<PoiWhitelistEntry>& whitelist) {
+    std::vector<PoiWhitelistEntry> entries;
+    for (const auto& w : whitelist) {
+        bool seen = std::ranges::any_of(entries, [&](const auto& e) { return e.key == w.key && e.value == w.value; });
+        if (!seen) entries.push_back(w);
+    }
+    return entries;
 }
 
-// Get current ISO8601 time
-std::string currentIsoTime() {
-    auto now = std::chrono::system_clock::now();
-    std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-    std::tm now_tm = *std::gmtime(&now_c);
-    char buf[30];
-    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &now_tm);
-    return std::string(buf);
+// Records the tag projection of a query and what it saved in `query.projection`
+void reportProjection(nlohmann::json& result, const std::optional<std::vector<std::string>>& tags,
+                      std::size_t responseBytes, std::size_t tagBytesDropped) {
+    if (!tags) return;
+    result["query"]["projection"] = {
+        {"tags", *tags},
+        {"response_bytes", responseBytes},
+        {"tag_bytes_dropped", tagBytesDropped},
+    };
+}
+
+// Split report attached to results of adaptive queries
+nlohmann::json splittingJson(int depth, std::size_t requests) {
+    return {{"max_depth", depth}, {"requests", requests}};
+}
+
+// Elements of an area, possibly assembled from split sub-areas
+struct AreaElements {
+    nlohmann::json elements;
+    int depth = 0;             // deepest split level that was needed
+    std::size_t requests = 0;  // Overpass requests issued
+    std::size_t bytes = 0;     // response bytes received
+    std::size_t tagBytesDropped = 0; // tag bytes the projection dropped
+};
+
+using AreaCallback = std::function<void(std::expected<AreaElements, std::string>)>;
+
+// Sends one Overpass query for an area filter
+using AreaQuery = std::function<void(const std::string& filter, AreaCallback)>;
+
+// Sends one Overpass POST, with the contract of AsyncEngine::submit()
+using Submit = std::function<void(std::string postData, AsyncEngine::Completion, CurlPool::ChunkSink)>;
+
+// AreaQuery that posts its area queries through @p submit
+std::shared_ptr<const AreaQuery> areaQuery(Submit submit, std::vector<PoiWhitelistEntry> whitelist,
+                                           std::optional<std::vector<std::string>> tags,
+                                           std::function<std::string(const std::string&)> postData) {
+    return std::make_shared<const AreaQuery>(
+        [submit = std::move(submit), whitelist = std::move(whitelist), tags = std::move(tags),
+         postData = std::move(postData)](const std::string& filter, AreaCallback done) {
+            auto collector = std::make_shared<ElementCollector>(whitelist, tags);
+            submit(postData(filter),
+                [collector, done = std::move(done)](std::expected<std::string, std::string> response) {
+                    auto elements = collector->finish(response);
+                    if (!elements) return done(std::unexpected(elements.error()));
+
+                    done(AreaElements{std::move(*elements), 0, 1, collector->bytes(), collector->tagBytesDropped()});
+                },
+                collector->sink());
+        });
+}
+
+// Fetches an area. On a splittable error the box is split into quadrants
+// (or first at the antimeridian, if it crosses it), which are fetched concurrently (each still clipped by the circle filter,
+// if any) and merged, until every piece succeeds or maxDepth is reached.
+void fetchSplitting(std::shared_ptr<const AreaQuery> query, std::string circle, tiles::BBox box,
+                    bool clip, int depth, int maxDepth, AreaCallback done) {
+    std::string filter = clip ? circle + bboxFilter(box) : circle;
+    const auto& send = *query;
+    send(filter, [query, circle, box, depth, maxDepth, done = std::move(done)](
+                     std::expected<AreaElements, std::string> area) {
+        if (area) {
+            area->depth = depth;
+            return done(std::move(area));
+        }
+        if (depth >= maxDepth || !isSplittableError(area.error())) return done(std::move(area));
+
+        // A box reaching across the antimeridian is first cut there, so every
+        // piece has a bbox filter within ±180
+        auto pieces = tiles::splitAntimeridian(box);
+        if (pieces.size() == 1) {
+            auto quadrants = tiles::quadrants(pieces.front());
+            pieces.assign(quadrants.begin(), quadrants.end());
+        }
+
+        struct Join {
+            std::mutex mutex;
+            std::size_t remaining = 0;
+            std::vector<AreaElements> parts;
+            std::string error;
+            AreaCallback done;
+        };
+        auto join = std::make_shared<Join>();
+        join->remaining = pieces.size();
+        join->done = done;
+
+        for (const auto& pieceBox : pieces) {
+            fetchSplitting(query, circle, pieceBox, true, depth + 1, maxDepth,
+                [join](std::expected<AreaElements, std::string> part) {
+                    {
+                        std::lock_guard lock(join->mutex);
+                        if (part) join->parts.push_back(std::move(*part));
+                        else if (join->error.empty()) join->error = std::move(part.error());
+                        if (--join->remaining != 0) return;
+                    }
+                    if (!join->error.empty()) return join->done(std::unexpected(join->error));
+
+                    // Elements on shared edges, and ways reaching into several
+                    // quadrants, are dropped when the result is built
+                    AreaElements merged{nlohmann::json::array()};
+                    merged.requests = 1;
+                    for (auto& piece : join->parts) {
+                        merged.depth = std::max(merged.depth, piece.depth);
+                        merged.requests += piece.requests;
+                        merged.bytes += piece.bytes;
+                        merged.tagBytesDropped += piece.tagBytesDropped;
+                        for (auto& element : piece.elements) merged.elements.push_back(std::move(element));
+                    }
+                    join->done(std::move(merged));
+                });
+        }
+    });
+}
+
+// Collects the totals of an `out count` response
+OverpassStream::Sink countSink(std::vector<std::size_t>& counts) {
+    return [&counts](const OsmElement& element) {
+        if (std::string_view(element.type) != "count") return;
+        std::size_t total = 0;
+        for (const auto& [key, value] : element.tags) {
+            if (std::string_view(key) == "total") std::from_chars(value.data(), value.data() + value.size(), total);
+        }
+        counts.push_back(total);
+    };
 }
 
+// Checks the totals of a count query: the total first, then one per distinct entry
+std::expected<std::vector<std::size_t>, std::string> checkedCounts(std::vector<std::size_t> counts,
+                                                                   const std::vector<PoiWhitelistEntry>& whitelist) {
+    // A single entry is counted by the total
+    auto entries = distinctEntries(whitelist);
+    if (entries.size() == 1 && counts.size() == 1) counts.push_back(counts.front());
+    if (counts.size() != 1 + entries.size()) {
+        return std::unexpected(std::format("Overpass API returned {} counts, expected {}", counts.size(), 1 + entries.size()));
+    }
+    return counts;
+}
+
+// Awaits a callback-driven query whose requests run on the awaiting task's
+// reactor. The callback must be the last thing the query does, since it may
+// resume (and finish) the awaiting coroutine.
+class CallbackAwaiter {
+public:
+    explicit CallbackAwaiter(std::function<void(PoiQueryCallback)> start) : start_(std::move(start)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    // Does not suspend if the query completed without a request, e.g. from cached tiles
+    bool await_suspend(std::coroutine_handle<> awaiter) {
+        awaiter_ = awaiter;
+        start_([this](PoiQueryResult result) {
+            result_ = std::move(result);
+            if (suspended_) awaiter_.resume();
+        });
+        suspended_ = !result_;
+        return suspended_;
+    }
+
+    PoiQueryResult await_resume() { return std::move(*result_); }
+
+private:
+    std::function<void(PoiQueryCallback)> start_;
+    std::coroutine_handle<> awaiter_;
+    std::optional<PoiQueryResult> result_;
+    bool suspended_ = false;
+};
+
 } // namespace
 
+PoiOsmClient::PoiOsmClient() : PoiOsmClient(PoiOsmClientOptions{}) {}
+
+PoiOsmClient::PoiOsmClient(PoiOsmClientOptions options)
+    : options_(std::move(options)),
+      geocodeCache_(std::make_unique<GeocodeCache>(options_.geocodeCacheCapacity, options_.geocodeCacheTtl,
+                                                   options_.geocodeNegativeCacheTtl)),
+      resultCache_(std::make_unique<SpatialCache>(options_.resultCacheCapacity, options_.resultCacheTtl,
+                                                  !dropsAllTags(options_.tags))),
+      tileCache_(std::make_unique<TileCache>(options_.tileCacheCapacity, options_.resultCacheTtl)),
+      pool_(std::make_unique<CurlPool>(options_.maxPooledHandles, options_.caBundle)),
+      engine_(std::make_unique<AsyncEngine>(*pool_, options_.maxConnectionsPerHost,
+                                            options_.maxTotalConnections)) {}
+
+PoiOsmClient::~PoiOsmClient() = default;
+PoiOsmClient::PoiOsmClient(PoiOsmClient&&) noexcept = default;
+PoiOsmClient& PoiOsmClient::operator=(PoiOsmClient&&) noexcept = default;
+
 std::expected<nlohmann::json, std::string> PoiOsmClient::queryByAddress(
     const std::string& address, int radiusMeters,
     const std::vector<PoiWhitelistEntry>& whitelist) {
@@ -102,38 +447,248 @@ std::expected<nlohmann::json, std::string> PoiOsmClient::queryByAddress(
     auto coords = geocodeAddress_(address);
     if (!coords) return std::unexpected(coords.error());
 
-    nlohmann::json input;
-    input["address"] = address;
-    input["lat"] = nullptr;
-    input["lon"] = nullptr;
-
-    return queryOverpass_(coords->first, coords->second, radiusMeters, whitelist, input);
+    return queryOverpass_(coords->first, coords->second, radiusMeters, whitelist, addressInput(address), selection_());
 }
 
 std::expected<nlohmann::json, std::string> PoiOsmClient::queryByCoordinates(
     double lat, double lon, int radiusMeters,
     const std::vector<PoiWhitelistEntry>& whitelist) {
     
-    nlohmann::json input;
-    input["address"] = nullptr;
-    input["lat"] = lat;
-    input["lon"] = lon;
+    return queryOverpass_(lat, lon, radiusMeters, whitelist, coordinatesInput(lat, lon), selection_());
+}
 
-    return queryOverpass_(lat, lon, radiusMeters, whitelist, input);
+std::expected<nlohmann::json, std::string> PoiOsmClient::streamByAddress(
+    const std::string& address, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist,
+    const PoiSink& sink) {
+
+    auto coords = geocodeAddress_(address);
+    if (!coords) return std::unexpected(coords.error());
+
+    return streamOverpass_(coords->first, coords->second, radiusMeters, whitelist, addressInput(address), sink);
+}
+
+std::expected<nlohmann::json, std::string> PoiOsmClient::streamByCoordinates(
+    double lat, double lon, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist,
+    const PoiSink& sink) {
+
+    return streamOverpass_(lat, lon, radiusMeters, whitelist, coordinatesInput(lat, lon), sink);
+}
+
+std::expected<PoiResult, std::string> PoiOsmClient::queryByAddressTyped(
+    const std::string& address, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist) {
+
+    auto coords = geocodeAddress_(address);
+    if (!coords) return std::unexpected(coords.error());
+
+    return queryOverpassTyped_(coords->first, coords->second, radiusMeters, whitelist, addressInput(address));
+}
+
+std::expected<PoiResult, std::string> PoiOsmClient::queryByCoordinatesTyped(
+    double lat, double lon, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist) {
+
+    return queryOverpassTyped_(lat, lon, radiusMeters, whitelist, coordinatesInput(lat, lon));
+}
+
+std::expected<nlohmann::json, std::string> PoiOsmClient::queryCountByAddress(
+    const std::string& address, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist) {
+
+    auto coords = geocodeAddress_(address);
+    if (!coords) return std::unexpected(coords.error());
+
+    return queryCount_(coords->first, coords->second, radiusMeters, whitelist, addressInput(address));
+}
+
+std::expected<nlohmann::json, std::string> PoiOsmClient::queryCountByCoordinates(
+    double lat, double lon, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist) {
+
+    return queryCount_(lat, lon, radiusMeters, whitelist, coordinatesInput(lat, lon));
+}
+
+std::expected<nlohmann::json, std::string> PoiOsmClient::queryNearestByAddress(
+    const std::string& address, std::size_t count,
+    const std::vector<PoiWhitelistEntry>& whitelist,
+    int maxRadiusMeters) {
+
+    auto coords = geocodeAddress_(address);
+    if (!coords) return std::unexpected(coords.error());
+
+    return queryNearest_(coords->first, coords->second, count, maxRadiusMeters, whitelist, addressInput(address));
+}
+
+std::expected<nlohmann::json, std::string> PoiOsmClient::queryNearestByCoordinates(
+    double lat, double lon, std::size_t count,
+    const std::vector<PoiWhitelistEntry>& whitelist,
+    int maxRadiusMeters) {
+
+    return queryNearest_(lat, lon, count, maxRadiusMeters, whitelist, coordinatesInput(lat, lon));
+}
+
+std::future<PoiQueryResult> PoiOsmClient::queryByAddressAsync(
+    const std::string& address, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist) {
+
+    auto promise = std::make_shared<std::promise<PoiQueryResult>>();
+    auto future = promise->get_future();
+    queryByAddressAsync(address, radiusMeters, whitelist,
+                        [promise](PoiQueryResult result) { promise->set_value(std::move(result)); });
+    return future;
+}
+
+void PoiOsmClient::queryByAddressAsync(
+    const std::string& address, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist,
+    PoiQueryCallback done) {
+
+    if (auto cached = cachedGeocode_(address)) {
+        if (!*cached) return done(std::unexpected(cached->error()));
+        return queryOverpassAsync_((*cached)->first, (*cached)->second, radiusMeters, whitelist,
+                                   addressInput(address), std::move(done));
+    }
+
+    engine_->submit(geocodeUrl_(address), {},
+        [this, address, radiusMeters, whitelist, done = std::move(done)](
+            std::expected<std::string, std::string> response) mutable {
+            if (!response) return done(std::unexpected(response.error()));
+
+            auto coords = parseGeocodeResponse_(*response);
+            rememberGeocode_(address, coords);
+            if (!coords) return done(std::unexpected(coords.error()));
+
+            queryOverpassAsync_(coords->first, coords->second, radiusMeters, std::move(whitelist),
+                                addressInput(address), std::move(done));
+        });
+}
+
+std::future<PoiQueryResult> PoiOsmClient::queryByCoordinatesAsync(
+    double lat, double lon, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist) {
+
+    auto promise = std::make_shared<std::promise<PoiQueryResult>>();
+    auto future = promise->get_future();
+    queryByCoordinatesAsync(lat, lon, radiusMeters, whitelist,
+                            [promise](PoiQueryResult result) { promise->set_value(std::move(result)); });
+    return future;
+}
+
+void PoiOsmClient::queryByCoordinatesAsync(
+    double lat, double lon, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist,
+    PoiQueryCallback done) {
+
+    queryOverpassAsync_(lat, lon, radiusMeters, whitelist, coordinatesInput(lat, lon), std::move(done));
+}
+
+PoiTask<PoiQueryResult> PoiOsmClient::queryByAddressTask(
+    PoiOsmReactor& reactor, std::string address, int radiusMeters,
+    std::vector<PoiWhitelistEntry> whitelist) {
+
+    GeocodeCache::Result coords;
+    if (auto cached = cachedGeocode_(address)) {
+        coords = std::move(*cached);
+    } else {
+        auto response = co_await reactor.fetch_(*pool_, geocodeUrl_(address));
+        if (!response) co_return std::unexpected(response.error());
+
+        coords = parseGeocodeResponse_(*response);
+        rememberGeocode_(address, coords);
+    }
+    if (!coords) co_return std::unexpected(coords.error());
+
+    co_return co_await queryOverpassTask_(reactor, coords->first, coords->second, radiusMeters,
+                                          std::move(whitelist), addressInput(address));
+}
+
+PoiTask<PoiQueryResult> PoiOsmClient::queryByCoordinatesTask(
+    PoiOsmReactor& reactor, double lat, double lon, int radiusMeters,
+    std::vector<PoiWhitelistEntry> whitelist) {
+
+    co_return co_await queryOverpassTask_(reactor, lat, lon, radiusMeters, std::move(whitelist),
+                                          coordinatesInput(lat, lon));
 }
 
 std::expected<std::pair<double, double>, std::string> PoiOsmClient::geocodeAddress_(const std::string& address) {
-    CurlHandle handle; // Just for escaping
-    std::string encodedAddr = urlEncode(handle.curl, address);
-    std::string url = std::format("https://nominatim.openstreetmap.org/search?q={}&format=json&limit=1", encodedAddr);
+    if (auto cached = cachedGeocode_(address)) return *cached;
 
-    auto response = performRequest(url);
+    auto response = pool_->perform(geocodeUrl_(address));
     if (!response) return std::unexpected(response.error());
 
+    auto coords = parseGeocodeResponse_(*response);
+    rememberGeocode_(address, coords);
+    return coords;
+}
+
+PoiCacheStats PoiOsmClient::geocodeCacheStats() const {
+    return geocodeCache_->stats();
+}
+
+PoiCacheStats PoiOsmClient::resultCacheStats() const {
+    return resultCache_->stats();
+}
+
+PoiCacheStats PoiOsmClient::tileCacheStats() const {
+    return tileCache_->stats();
+}
+
+std::expected<void, std::string> PoiOsmClient::openGeocodeStore(const std::string& path) {
+    auto store = GeocodeStore::open(path);
+    if (!store) return std::unexpected(store.error());
+
+    geocodeStore_ = std::move(*store);
+    return {};
+}
+
+std::expected<void, std::string> PoiOsmClient::openPoiStore(const std::string& path) {
+    auto store = PoiStore::open(path);
+    if (!store) return std::unexpected(store.error());
+
+    poiStore_ = std::move(*store);
+    return {};
+}
+
+std::expected<PoiImportStats, std::string> PoiOsmClient::buildPoiStore(const std::string& pbfPath,
+                                                                       const std::string& storePath,
+                                                                       const PoiImportOptions& options) {
+    return PoiStoreBuilder(options).build(pbfPath, storePath);
+}
+
+std::optional<std::expected<std::pair<double, double>, std::string>> PoiOsmClient::cachedGeocode_(
+    const std::string& address) {
+
+    if (auto cached = geocodeCache_->lookup(address)) return cached;
+    if (!geocodeStore_) return std::nullopt;
+
+    auto stored = geocodeStore_->lookup(address, options_.geocodeCacheTtl, options_.geocodeNegativeCacheTtl);
+    if (stored) geocodeCache_->store(address, *stored);
+    return stored;
+}
+
+void PoiOsmClient::rememberGeocode_(
+    const std::string& address, const std::expected<std::pair<double, double>, std::string>& coords) {
+
+    if (!isCacheableGeocode(coords)) return;
+    geocodeCache_->store(address, coords);
+    // A failed write only costs a future network round trip
+    if (geocodeStore_) (void)geocodeStore_->store(address, coords);
+}
+
+std::string PoiOsmClient::geocodeUrl_(const std::string& address) {
+    std::string encodedAddr = pool_->escape(address);
+    return std::format("{}?q={}&format=json&limit=1", options_.nominatimEndpoint, encodedAddr);
+}
+
+std::expected<std::pair<double, double>, std::string> PoiOsmClient::parseGeocodeResponse_(
+    const std::string& response) const {
+
     try {
-        auto json = nlohmann::json::parse(*response);
+        auto json = nlohmann::json::parse(response);
         if (!json.is_array()) return std::unexpected("Invalid geocoding response: Not an array");
-        if (json.empty()) return std::unexpected("No geocoding result for address");
+        if (json.empty()) return std::unexpected(GeocodeCache::kNoResult);
 
         const auto& obj = json[0];
         // Nominatim returns lat/lon as strings
@@ -153,61 +708,805 @@ std::expected<std::pair<double, double>, std::string> PoiOsmClient::geocodeAddre
 std::expected<nlohmann::json, std::string> PoiOsmClient::queryOverpass_(
     double lat, double lon, int radiusMeters,
     const std::vector<PoiWhitelistEntry>& whitelist,
-    const nlohmann::json& queryInput) {
+    const nlohmann::json& queryInput,
+    Selection selection) {
+
+    if (storeCovers_(lat, lon, radiusMeters, whitelist)) {
+        return storeResult_(lat, lon, radiusMeters, whitelist, queryInput, selection);
+    }
+    if (auto cached = cachedResult_(lat, lon, radiusMeters, whitelist, queryInput, selection)) return *cached;
+
+    // A pre-flight count picks between one query and tiles; if it fails the
+    // circle is fetched as configured
+    bool tiled = options_.tiledFetch;
+    std::optional<std::size_t> estimate;
+    if (!tiled && options_.tileThreshold != 0) {
+        if (auto counts = countOverpass_(lat, lon, radiusMeters, whitelist)) estimate = counts->front();
+        tiled = estimate && *estimate > options_.tileThreshold;
+    }
+
+    // Tiles and split areas are fetched concurrently
+    if (tiled || options_.adaptiveSplit) {
+        PoiQueryResult result;
+        runBlocking_([&](PoiOsmReactor* reactor, std::function<void()> finished) {
+            fetchOverpassAsync_(lat, lon, radiusMeters, whitelist, queryInput, tiled, selection, reactor,
+                [&result, finished = std::move(finished)](PoiQueryResult fetched) {
+                    result = std::move(fetched);
+                    finished();
+                });
+        });
+        if (result && estimate) (*result)["query"]["estimate"] = {{"elements", *estimate}, {"tiled", tiled}};
+        return result;
+    }
 
     std::string query = buildOverpassQuery_(lat, lon, radiusMeters, whitelist);
     
-    // Overpass expects body: data=query
-    CurlHandle handle;
-    std::string postData = "data=" + urlEncode(handle.curl, query);
+    ElementCollector collector(whitelist, options_.tags);
+    auto transfer = pool_->perform(options_.overpassEndpoint, overpassPostData_(query), collector.sink());
+    auto elements = collector.finish(transfer);
+    if (!elements) return std::unexpected(elements.error());
 
-    auto response = performRequest("https://overpass-api.de/api/interpreter", postData);
-    if (!response) return std::unexpected(response.error());
+    auto result = overpassResult_(*elements, collector.bytes(), collector.tagBytesDropped(), lat, lon, radiusMeters,
+                                  whitelist, queryInput, selection);
+    if (estimate) result["query"]["estimate"] = {{"elements", *estimate}, {"tiled", false}};
+    return result;
+}
 
-    try {
-        auto json = nlohmann::json::parse(*response);
-        if (json.contains("remark") && !json.contains("elements")) {
-             return std::unexpected(std::format("Overpass API Error: {}", json["remark"].get<std::string>()));
+std::expected<std::vector<std::size_t>, std::string> PoiOsmClient::countOverpass_(
+    double lat, double lon, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist) {
+
+    std::string query = buildOverpassCountQuery_(aroundFilter(lat, lon, radiusMeters), whitelist);
+
+    std::vector<std::size_t> counts;
+    ElementCollector collector({}, std::nullopt, countSink(counts));
+    auto transfer = pool_->perform(options_.overpassEndpoint, overpassPostData_(query), collector.sink());
+    if (auto status = collector.finish(transfer); !status) return std::unexpected(status.error());
+
+    return checkedCounts(std::move(counts), whitelist);
+}
+
+std::expected<nlohmann::json, std::string> PoiOsmClient::queryCount_(
+    double lat, double lon, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist,
+    const nlohmann::json& queryInput) {
+
+    auto entries = distinctEntries(whitelist);
+    bool fromStore = storeCovers_(lat, lon, radiusMeters, whitelist);
+    auto counts = fromStore ? storeCounts_(lat, lon, radiusMeters, whitelist, entries)
+                            : countOverpass_(lat, lon, radiusMeters, whitelist);
+    if (!counts) return std::unexpected(counts.error());
+
+    nlohmann::json perEntry = nlohmann::json::array();
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        perEntry.push_back({{"key", entries[i].key}, {"value", entries[i].value}, {"count", (*counts)[i + 1]}});
+    }
+
+    auto result = wrapResultJson_(lat, lon, radiusMeters, whitelist, nlohmann::json::array(), queryInput);
+    auto& results = result["results"];
+    results.erase("pois");
+    results.erase("duplicates_dropped");
+    results["count"] = counts->front();
+    results["counts"] = std::move(perEntry);
+    if (fromStore) result["source"]["poi_store"] = poiStore_->path();
+    return result;
+}
+
+std::expected<nlohmann::json, std::string> PoiOsmClient::streamOverpass_(
+    double lat, double lon, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist,
+    const nlohmann::json& queryInput,
+    const PoiSink& sink) {
+
+    // Tiles and split areas can only be merged once all pieces are in
+    bool fromStore = storeCovers_(lat, lon, radiusMeters, whitelist);
+    if (!fromStore && (options_.tiledFetch || options_.adaptiveSplit)) {
+        auto result = queryOverpass_(lat, lon, radiusMeters, whitelist, queryInput, selection_());
+        if (!result) return result;
+
+        for (const auto& poi : (*result)["results"]["pois"]) sink(poi);
+        (*result)["results"].erase("pois");
+        return result;
+    }
+
+    std::size_t count = 0;
+    std::size_t duplicates = 0;
+    std::size_t responseBytes = 0;
+    std::size_t tagBytesDropped = 0;
+    if (auto cached = fromStore ? std::nullopt : resultCache_->lookup(lat, lon, radiusMeters, whitelist)) {
+        auto chosen = selectPois_(std::move(cached->pois), cached->distances, selection_());
+        for (const auto& poi : chosen) sink(poi);
+        count = chosen.size();
+    } else {
+        // POIs go to the sink as they are parsed and are not kept for the result cache
+        // Sorted output can only start once every POI is known; the selector
+        // then holds the nearest ones
+        bool waysAndRelations = options_.includeWaysAndRelations;
+        bool sorted = options_.sort == PoiSortOrder::Distance;
+        PoiSelector<nlohmann::json> nearest(options_.limit, options_.sort);
+        IdSet seen;
+        auto onElement = [&](const OsmElement& element) {
+            if (!isPoiType(element.type, waysAndRelations)) return;
+            if (!seen.insert(osmKey(element.type, element.id))) {
+                ++duplicates;
+                return;
+            }
+
+            double distance = geo::haversineMeters(lat, lon, element.lat, element.lon);
+            if (sorted) {
+                if (nearest.accepts(distance)) nearest.add(distance, poiJson(element, distance));
+            } else if (options_.limit == 0 || count < options_.limit) {
+                sink(poiJson(element, distance));
+                ++count;
+            }
+        };
+
+        if (fromStore) {
+            tagBytesDropped = queryStore_(lat, lon, radiusMeters, whitelist, onElement);
+        } else {
+            ElementCollector collector(whitelist, options_.tags, onElement);
+            std::string query = buildOverpassQuery_(lat, lon, radiusMeters, whitelist);
+            auto transfer = pool_->perform(options_.overpassEndpoint, overpassPostData_(query), collector.sink());
+            if (auto status = collector.finish(transfer); !status) return std::unexpected(status.error());
+            responseBytes = collector.bytes();
+            tagBytesDropped = collector.tagBytesDropped();
         }
 
-        if (!json.is_object() || !json.contains("elements")) {
-             // Sometimes Overpass returns HTML on error
-             if (response->find("<html") != std::string::npos) {
-                 return std::unexpected("Overpass API returned HTML error (server might be busy)");
-             }
-             return std::unexpected("Invalid Overpass JSON response");
+        for (const auto& [distance, poi] : nearest.take()) {
+            sink(poi);
+            ++count;
         }
+    }
 
-        return buildResultJson_(lat, lon, radiusMeters, whitelist, json["elements"], queryInput);
+    auto summary = wrapResultJson_(lat, lon, radiusMeters, whitelist, nlohmann::json::array(), queryInput, duplicates);
+    summary["results"].erase("pois");
+    summary["results"]["count"] = count;
+    if (fromStore) summary["source"]["poi_store"] = poiStore_->path();
+    reportProjection(summary, options_.tags, responseBytes, tagBytesDropped);
+    return summary;
+}
 
-    } catch (const nlohmann::json::parse_error& e) {
-        return std::unexpected(std::format("JSON parse error: {}", e.what()));
+std::expected<nlohmann::json, std::string> PoiOsmClient::queryNearest_(
+    double lat, double lon, std::size_t count, int maxRadiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist,
+    const nlohmann::json& queryInput) {
+
+    constexpr int kFirstRadiusMeters = 1000;
+    constexpr int kGrowthFactor = 4;
+
+    // A client limit caps the answer
+    std::size_t wanted = options_.limit == 0 ? count : std::min(count, options_.limit);
+    if (wanted == 0) {
+        auto result = wrapResultJson_(lat, lon, maxRadiusMeters, whitelist, nlohmann::json::array(), queryInput);
+        reportProjection(result, options_.tags, 0, 0);
+        result["query"]["nearest"] = {{"count", count}, {"rounds", 0}, {"radius_m", 0}};
+        return result;
+    }
+
+    // The store's index searches outwards from the center itself, so one round does
+    if (storeCovers_(lat, lon, maxRadiusMeters, whitelist)) {
+        nlohmann::json pois = nlohmann::json::array();
+        std::size_t tagBytesDropped = poiStore_->nearest(
+            lat, lon, wanted, maxRadiusMeters, whitelist, options_.includeWaysAndRelations,
+            TagProjection(options_.tags, clientWhitelist(whitelist, options_.tags)), [&](const OsmElement& element) {
+                pois.push_back(poiJson(element, geo::haversineMeters(lat, lon, element.lat, element.lon)));
+            });
+
+        auto result = wrapResultJson_(lat, lon, maxRadiusMeters, whitelist, std::move(pois), queryInput);
+        result["source"]["poi_store"] = poiStore_->path();
+        reportProjection(result, options_.tags, 0, tagBytesDropped);
+        result["query"]["nearest"] = {{"count", count}, {"rounds", 1}, {"radius_m", maxRadiusMeters}};
+        return result;
+    }
+
+    // Each round holds every POI of its circle, so the nearest are chosen
+    // among all of them rather than among the first the client limit lets through
+    const Selection unlimited{0, PoiSortOrder::None};
+    int radius = std::min(kFirstRadiusMeters, maxRadiusMeters);
+    int searched = 0;              // radius of the previous round, if it was fetched as a whole
+    nlohmann::json found;          // its POIs
+    std::size_t circleBytes = 0;   // response bytes of its circle
+    nlohmann::json bytesPerRound = nlohmann::json::array();
+    for (int round = 1;; ++round) {
+        std::expected<nlohmann::json, std::string> result;
+        std::size_t bytes = 0;
+
+        // The store, the result cache and tiles place ways and relations by
+        // their center, while Overpass matches a circle by their geometry, so
+        // with them only Overpass rounds are what the next ring leaves out
+        bool whole = !options_.includeWaysAndRelations;
+        bool tiled = options_.tiledFetch;
+        std::optional<std::size_t> estimate;
+        if (storeCovers_(lat, lon, radius, whitelist)) {
+            result = storeResult_(lat, lon, radius, whitelist, queryInput, unlimited);
+            circleBytes = 0;
+        } else if (auto cached = cachedResult_(lat, lon, radius, whitelist, queryInput, unlimited)) {
+            result = std::move(*cached);
+            circleBytes = 0;
+        } else {
+            if (!tiled && options_.tileThreshold != 0) {
+                if (auto counts = countOverpass_(lat, lon, radius, whitelist)) estimate = counts->front();
+                tiled = estimate && *estimate > options_.tileThreshold;
+            }
+            if (tiled) {
+                // The tiles of earlier rounds come from the tile cache
+                runBlocking_([&](PoiOsmReactor* reactor, std::function<void()> finished) {
+                    fetchOverpassAsync_(lat, lon, radius, whitelist, queryInput, true, unlimited, reactor,
+                        [&result, finished = std::move(finished)](PoiQueryResult fetched) {
+                            result = std::move(fetched);
+                            finished();
+                        });
+                });
+                if (!result) return result;
+                bytes = (*result)["query"]["tiling"]["bytes"].get<std::size_t>();
+                circleBytes = 0;
+            } else {
+                // Only the ring beyond the previous round is fetched
+                std::expected<AreaElements, std::string> ring;
+                std::string exclude = searched == 0 ? std::string() : aroundFilter(lat, lon, searched);
+                runBlocking_([&](PoiOsmReactor* reactor, std::function<void()> finished) {
+                    auto query = areaQuery(overpassSubmit_(reactor), whitelist, options_.tags,
+                        [this, whitelist, exclude](const std::string& filter) {
+                            return overpassPostData_(buildOverpassAreaQuery_(filter, whitelist, exclude));
+                        });
+                    fetchSplitting(std::move(query), aroundFilter(lat, lon, radius),
+                                   tiles::circleBounds(lat, lon, radius), false, 0,
+                                   options_.adaptiveSplit ? options_.maxSplitDepth : 0,
+                        [&ring, finished = std::move(finished)](std::expected<AreaElements, std::string> fetched) {
+                            ring = std::move(fetched);
+                            finished();
+                        });
+                });
+                if (!ring) return std::unexpected(ring.error());
+
+                result = buildResultJson_(lat, lon, radius, whitelist, ring->elements, queryInput, unlimited);
+                auto& pois = (*result)["results"]["pois"];
+                if (searched != 0) {
+                    for (auto& poi : found) pois.push_back(std::move(poi));
+                    (*result)["results"]["count"] = pois.size();
+                } else {
+                    circleBytes = 0;
+                }
+                bytes = ring->bytes;
+                circleBytes += bytes;
+                resultCache_->store(lat, lon, radius, whitelist, pois, circleBytes);
+                reportProjection(*result, options_.tags, bytes, ring->tagBytesDropped);
+                if (options_.adaptiveSplit) {
+                    (*result)["query"]["splitting"] = splittingJson(ring->depth, ring->requests);
+                }
+                whole = true;
+            }
+            if (estimate) (*result)["query"]["estimate"] = {{"elements", *estimate}, {"tiled", tiled}};
+        }
+        if (!result) return result;
+        bytesPerRound.push_back(bytes);
+
+        // Everything outside the circle is farther than anything in it. Ways
+        // and relations match by their geometry but are placed at their
+        // center, which can lie outside, so only POIs within the radius count.
+        PoiSelector<nlohmann::json> nearest(wanted, PoiSortOrder::Distance);
+        std::size_t inside = 0;
+        for (const auto& poi : (*result)["results"]["pois"]) {
+            double distance = poi.value("distance_m", 0.0);
+            if (distance > radius) continue;
+            ++inside;
+            if (nearest.accepts(distance)) nearest.add(distance, poi);
+        }
+
+        if (inside >= wanted || radius >= maxRadiusMeters) {
+            nlohmann::json chosen = nlohmann::json::array();
+            for (auto& [distance, poi] : nearest.take()) chosen.push_back(std::move(poi));
+            (*result)["results"]["count"] = chosen.size();
+            (*result)["results"]["pois"] = std::move(chosen);
+            (*result)["query"]["nearest"] = {
+                {"count", count},
+                {"rounds", round},
+                {"radius_m", radius},
+                {"bytes_per_round", std::move(bytesPerRound)},
+            };
+            return result;
+        }
+
+        searched = whole ? radius : 0;
+        if (whole) found = std::move((*result)["results"]["pois"]);
+        radius = radius > maxRadiusMeters / kGrowthFactor ? maxRadiusMeters : radius * kGrowthFactor;
+    }
+}
+
+std::expected<PoiResult, std::string> PoiOsmClient::queryOverpassTyped_(
+    double lat, double lon, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist,
+    const nlohmann::json& queryInput) {
+
+    auto envelope = [&](const nlohmann::json& query) {
+        nlohmann::json result = query;
+        result.erase("results");
+        return result;
+    };
+
+    // Tiles and split areas are merged as JSON; convert the merged POIs
+    bool fromStore = storeCovers_(lat, lon, radiusMeters, whitelist);
+    if (!fromStore && (options_.tiledFetch || options_.adaptiveSplit)) {
+        auto result = queryOverpass_(lat, lon, radiusMeters, whitelist, queryInput, selection_());
+        if (!result) return std::unexpected(result.error());
+
+        PoiResultBuilder builder(envelope(*result), (*result)["results"].value("duplicates_dropped", std::size_t{0}));
+        for (const auto& poi : (*result)["results"]["pois"]) builder.add(poi);
+        return builder.finish();
+    }
+
+    PoiResultBuilder builder(
+        envelope(wrapResultJson_(lat, lon, radiusMeters, whitelist, nlohmann::json::array(), queryInput)));
+
+    if (auto cached = fromStore ? std::nullopt : resultCache_->lookup(lat, lon, radiusMeters, whitelist)) {
+        for (const auto& poi : selectPois_(std::move(cached->pois), cached->distances, selection_())) builder.add(poi);
+        reportProjection(builder.envelope(), options_.tags, 0, 0);
+        return builder.finish();
+    }
+
+    // Without limit and sort elements go straight into the result; otherwise
+    // the chosen ones are copied out of the parser's arena until the end
+    bool waysAndRelations = options_.includeWaysAndRelations;
+    bool select = options_.limit != 0 || options_.sort != PoiSortOrder::None;
+    PoiSelector<OsmElement> chosen(options_.limit, options_.sort);
+    auto onElement = [&](const OsmElement& element) {
+        if (!isPoiType(element.type, waysAndRelations) || !builder.admit(element.type, element.id)) return;
+
+        double distance = geo::haversineMeters(lat, lon, element.lat, element.lon);
+        if (!select) builder.add(element, distance);
+        else if (chosen.accepts(distance)) chosen.add(distance, OsmElement(element));
+    };
+
+    std::size_t responseBytes = 0;
+    std::size_t tagBytesDropped = 0;
+    if (fromStore) {
+        tagBytesDropped = queryStore_(lat, lon, radiusMeters, whitelist, onElement);
+        builder.envelope()["source"]["poi_store"] = poiStore_->path();
+    } else {
+        ElementCollector collector(whitelist, options_.tags, onElement);
+        std::string query = buildOverpassQuery_(lat, lon, radiusMeters, whitelist);
+        auto transfer = pool_->perform(options_.overpassEndpoint, overpassPostData_(query), collector.sink());
+        if (auto status = collector.finish(transfer); !status) return std::unexpected(status.error());
+        responseBytes = collector.bytes();
+        tagBytesDropped = collector.tagBytesDropped();
+    }
+
+    for (const auto& [distance, element] : chosen.take()) builder.add(element, distance);
+    reportProjection(builder.envelope(), options_.tags, responseBytes, tagBytesDropped);
+    return builder.finish();
+}
+
+void PoiOsmClient::queryOverpassAsync_(
+    double lat, double lon, int radiusMeters,
+    std::vector<PoiWhitelistEntry> whitelist,
+    nlohmann::json queryInput,
+    PoiQueryCallback done) {
+
+    if (storeCovers_(lat, lon, radiusMeters, whitelist)) {
+        return done(storeResult_(lat, lon, radiusMeters, whitelist, queryInput, selection_()));
+    }
+    if (auto cached = cachedResult_(lat, lon, radiusMeters, whitelist, queryInput, selection_())) {
+        return done(std::move(*cached));
+    }
+
+    fetchOverpassAsync_(lat, lon, radiusMeters, std::move(whitelist), std::move(queryInput), options_.tiledFetch,
+                        selection_(), nullptr, std::move(done));
+}
+
+void PoiOsmClient::runBlocking_(const std::function<void(PoiOsmReactor*, std::function<void()>)>& start) {
+    // A completion callback runs on the event loop, which cannot wait for itself
+    if (engine_->onWorkerThread()) {
+        PoiOsmReactor reactor(options_.maxConnectionsPerHost);
+        start(&reactor, [] {});
+        reactor.run();
+        return;
+    }
+
+    std::promise<void> promise;
+    auto future = promise.get_future();
+    start(nullptr, [&promise] { promise.set_value(); });
+    future.wait();
+}
+
+PoiOsmClient::OverpassSubmit PoiOsmClient::overpassSubmit_(PoiOsmReactor* reactor) {
+    if (!reactor) {
+        return [this](std::string postData, AsyncEngine::Completion done, CurlPool::ChunkSink sink) {
+            engine_->submit(options_.overpassEndpoint, std::move(postData), std::move(done), std::move(sink));
+        };
+    }
+
+    // Each request is a task of its own on the reactor, completing like a submitted one
+    return [this, reactor](std::string postData, AsyncEngine::Completion done, CurlPool::ChunkSink sink) {
+        reactor->spawn([](PoiOsmReactor& on, CurlPool& pool, std::string url, std::string postData,
+                          AsyncEngine::Completion done, CurlPool::ChunkSink sink) -> PoiTask<void> {
+            done(co_await on.fetch_(pool, std::move(url), std::move(postData), std::move(sink)));
+        }(*reactor, *pool_, options_.overpassEndpoint, std::move(postData), std::move(done), std::move(sink)));
+    };
+}
+
+void PoiOsmClient::fetchOverpassAsync_(
+    double lat, double lon, int radiusMeters,
+    std::vector<PoiWhitelistEntry> whitelist,
+    nlohmann::json queryInput,
+    bool tiled,
+    Selection selection,
+    PoiOsmReactor* reactor,
+    PoiQueryCallback done) {
+
+    if (tiled) {
+        return queryTilesAsync_(lat, lon, radiusMeters, whitelist, queryInput, selection, reactor, std::move(done));
+    }
+
+    if (options_.adaptiveSplit) {
+        auto query = areaQuery(overpassSubmit_(reactor), whitelist, options_.tags,
+            [this, whitelist](const std::string& filter) {
+                return overpassPostData_(buildOverpassAreaQuery_(filter, whitelist));
+            });
+        return fetchSplitting(std::move(query), aroundFilter(lat, lon, radiusMeters),
+                              tiles::circleBounds(lat, lon, radiusMeters), false, 0, options_.maxSplitDepth,
+            [this, lat, lon, radiusMeters, whitelist, queryInput, selection, done = std::move(done)](
+                std::expected<AreaElements, std::string> fetched) {
+                if (!fetched) return done(std::unexpected(fetched.error()));
+
+                auto result = overpassResult_(fetched->elements, fetched->bytes, fetched->tagBytesDropped, lat, lon,
+                                              radiusMeters, whitelist, queryInput, selection);
+                result["query"]["splitting"] = splittingJson(fetched->depth, fetched->requests);
+                done(std::move(result));
+            });
+    }
+
+    std::string query = buildOverpassQuery_(lat, lon, radiusMeters, whitelist);
+
+    auto collector = std::make_shared<ElementCollector>(whitelist, options_.tags);
+    overpassSubmit_(reactor)(overpassPostData_(query),
+        [this, collector, lat, lon, radiusMeters, whitelist = std::move(whitelist),
+         queryInput = std::move(queryInput), selection, done = std::move(done)](
+            std::expected<std::string, std::string> response) {
+            auto elements = collector->finish(response);
+            if (!elements) return done(std::unexpected(elements.error()));
+
+            done(overpassResult_(*elements, collector->bytes(), collector->tagBytesDropped(), lat, lon, radiusMeters,
+                                 whitelist, queryInput, selection));
+        },
+        collector->sink());
+}
+
+PoiTask<PoiQueryResult> PoiOsmClient::queryOverpassTask_(
+    PoiOsmReactor& reactor,
+    double lat, double lon, int radiusMeters,
+    std::vector<PoiWhitelistEntry> whitelist,
+    nlohmann::json queryInput) {
+
+    if (storeCovers_(lat, lon, radiusMeters, whitelist)) {
+        co_return storeResult_(lat, lon, radiusMeters, whitelist, queryInput, selection_());
+    }
+    if (auto cached = cachedResult_(lat, lon, radiusMeters, whitelist, queryInput, selection_())) {
+        co_return std::move(*cached);
+    }
+
+    // As in queryOverpass_(), with every request awaited on the reactor
+    bool tiled = options_.tiledFetch;
+    std::optional<std::size_t> estimate;
+    if (!tiled && options_.tileThreshold != 0) {
+        std::vector<std::size_t> counts;
+        ElementCollector counter({}, std::nullopt, countSink(counts));
+        std::string countQuery = buildOverpassCountQuery_(aroundFilter(lat, lon, radiusMeters), whitelist);
+        auto transfer = co_await reactor.fetch_(*pool_, options_.overpassEndpoint, overpassPostData_(countQuery),
+                                                counter.sink());
+        if (counter.finish(transfer)) {
+            if (auto checked = checkedCounts(std::move(counts), whitelist)) estimate = checked->front();
+        }
+        tiled = estimate && *estimate > options_.tileThreshold;
+    }
+
+    if (tiled || options_.adaptiveSplit) {
+        auto result = co_await CallbackAwaiter([&](PoiQueryCallback done) {
+            fetchOverpassAsync_(lat, lon, radiusMeters, whitelist, queryInput, tiled, selection_(), &reactor,
+                                std::move(done));
+        });
+        if (result && estimate) (*result)["query"]["estimate"] = {{"elements", *estimate}, {"tiled", tiled}};
+        co_return result;
+    }
+
+    std::string query = buildOverpassQuery_(lat, lon, radiusMeters, whitelist);
+
+    ElementCollector collector(whitelist, options_.tags);
+    auto response = co_await reactor.fetch_(*pool_, options_.overpassEndpoint, overpassPostData_(query),
+                                            collector.sink());
+    auto elements = collector.finish(response);
+    if (!elements) co_return std::unexpected(elements.error());
+
+    auto result = overpassResult_(*elements, collector.bytes(), collector.tagBytesDropped(), lat, lon, radiusMeters,
+                                  whitelist, queryInput, selection_());
+    if (estimate) result["query"]["estimate"] = {{"elements", *estimate}, {"tiled", false}};
+    co_return result;
+}
+
+void PoiOsmClient::queryTilesAsync_(
+    double lat, double lon, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist,
+    const nlohmann::json& queryInput,
+    Selection selection,
+    PoiOsmReactor* reactor,
+    PoiQueryCallback done) {
+
+    // Collects the tiles of one query; the last completion merges them
+    struct Join {
+        std::mutex mutex;
+        std::size_t remaining = 0;
+        std::size_t fromCache = 0;
+        std::size_t bytes = 0;
+        std::size_t tagBytesDropped = 0;
+        std::size_t requests = 0;
+        int depth = 0;
+        std::vector<TileCache::Elements> parts;
+        std::string error;
+        std::function<void()> finish;
+    };
+
+    auto tileList = tiles::coverCircle(lat, lon, radiusMeters, options_.tileZoom);
+    auto join = std::make_shared<Join>();
+    join->remaining = tileList.size();
+    join->parts.reserve(tileList.size());
+
+    join->finish = [this, join = join.get(), lat, lon, radiusMeters, whitelist, queryInput, selection,
+                    done = std::move(done), tileCount = tileList.size()]() {
+        if (!join->error.empty()) return done(std::unexpected(join->error));
+
+        // Tiles overlap at their edges and ways span several tiles; the
+        // duplicates are dropped when the result is built. The elements of a
+        // tile reach past the circle, so each tile's positions are gathered
+        // into columns and cut to the circle by the vectorized filter.
+        nlohmann::json merged = nlohmann::json::array();
+        geo::RadiusFilter circle(lat, lon, radiusMeters);
+        std::vector<std::int32_t> lats;
+        std::vector<std::int32_t> lons;
+        std::vector<std::uint32_t> inside;
+        for (const auto& part : join->parts) {
+            lats.clear();
+            lons.clear();
+            for (const auto& element : *part) {
+                auto [elementLat, elementLon] = elementPosition(element);
+                lats.push_back(geo::quantize(elementLat));
+                lons.push_back(geo::quantize(elementLon));
+            }
+            inside.resize(lats.size());
+            std::size_t found = circle.filter(lats.data(), lons.data(), lats.size(), inside.data(), nullptr);
+            for (std::size_t k = 0; k < found; ++k) merged.push_back((*part)[inside[k]]);
+        }
+
+        auto result = buildResultJson_(lat, lon, radiusMeters, whitelist, merged, queryInput, selection);
+        if (selection.limit == 0) {
+            resultCache_->store(lat, lon, radiusMeters, whitelist, result["results"]["pois"], join->bytes);
+        }
+        result["query"]["tiling"] = {
+            {"zoom", options_.tileZoom},
+            {"tiles", tileCount},
+            {"tiles_from_cache", join->fromCache},
+            {"bytes", join->bytes},
+        };
+        if (options_.adaptiveSplit) result["query"]["splitting"] = splittingJson(join->depth, join->requests);
+        reportProjection(result, options_.tags, join->bytes, join->tagBytesDropped);
+        done(std::move(result));
+    };
+
+    auto complete = [join](TileCache::Elements elements, std::string error, const AreaElements& fetched) {
+        {
+            std::lock_guard lock(join->mutex);
+            if (elements && fetched.requests == 0) ++join->fromCache;
+            if (elements) join->parts.push_back(std::move(elements));
+            if (!error.empty() && join->error.empty()) join->error = std::move(error);
+            join->bytes += fetched.bytes;
+            join->tagBytesDropped += fetched.tagBytesDropped;
+            join->requests += fetched.requests;
+            join->depth = std::max(join->depth, fetched.depth);
+            if (--join->remaining != 0) return;
+        }
+        join->finish();
+    };
+
+    if (tileList.empty()) {
+        join->finish();
+        return;
+    }
+
+    auto query = areaQuery(overpassSubmit_(reactor), whitelist, options_.tags,
+        [this, whitelist](const std::string& filter) {
+            return overpassPostData_(buildOverpassAreaQuery_(filter, whitelist));
+        });
+    int maxDepth = options_.adaptiveSplit ? options_.maxSplitDepth : 0;
+    std::string whitelistKey = whitelist::canonical(whitelist);
+    for (const auto& tile : tileList) {
+        std::string key = tiles::quadkey(tile) + "|" + whitelistKey;
+        if (auto cached = tileCache_->lookup(key)) {
+            complete(std::move(cached), {}, AreaElements{});
+            continue;
+        }
+
+        fetchSplitting(query, {}, tiles::bounds(tile), true, 0, maxDepth,
+            [this, key, complete](std::expected<AreaElements, std::string> fetched) {
+                if (!fetched) return complete(nullptr, fetched.error(), AreaElements{});
+
+                auto shared = std::make_shared<const nlohmann::json>(std::move(fetched->elements));
+                tileCache_->store(key, shared);
+                complete(std::move(shared), {}, *fetched);
+            });
+    }
+}
+
+std::optional<nlohmann::json> PoiOsmClient::cachedResult_(
+    double lat, double lon, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist,
+    const nlohmann::json& queryInput,
+    Selection selection) const {
+
+    auto cached = resultCache_->lookup(lat, lon, radiusMeters, whitelist);
+    if (!cached) return std::nullopt;
+
+    auto result = wrapResultJson_(lat, lon, radiusMeters, whitelist,
+                                  selectPois_(std::move(cached->pois), cached->distances, selection), queryInput);
+    reportProjection(result, options_.tags, 0, 0);
+    return result;
+}
+
+bool PoiOsmClient::storeCovers_(double lat, double lon, int radiusMeters,
+                                const std::vector<PoiWhitelistEntry>& whitelist) const {
+    if (!poiStore_) return false;
+    if (options_.includeWaysAndRelations && !poiStore_->hasWaysAndRelations()) return false;
+    return poiStore_->answers(whitelist) && poiStore_->covers(lat, lon, radiusMeters);
+}
+
+std::size_t PoiOsmClient::queryStore_(double lat, double lon, int radiusMeters,
+                                      const std::vector<PoiWhitelistEntry>& whitelist,
+                                      const std::function<void(const OsmElement&)>& sink) const {
+    // The store matches all tags, so the projection behaves like `out skel`
+    // or a full response followed by the client-side projection
+    return poiStore_->query(lat, lon, radiusMeters, whitelist, options_.includeWaysAndRelations,
+                            TagProjection(options_.tags, clientWhitelist(whitelist, options_.tags)), sink);
+}
+
+nlohmann::json PoiOsmClient::storeResult_(
+    double lat, double lon, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist,
+    const nlohmann::json& queryInput,
+    Selection selection) const {
+
+    // Store POIs are unique elements, so they go straight into the selector
+    PoiSelector<nlohmann::json> chosen(selection.limit, selection.sort);
+    std::size_t tagBytesDropped = queryStore_(lat, lon, radiusMeters, whitelist, [&](const OsmElement& element) {
+        double distance = geo::haversineMeters(lat, lon, element.lat, element.lon);
+        if (chosen.accepts(distance)) chosen.add(distance, poiJson(element, distance));
+    });
+
+    nlohmann::json pois = nlohmann::json::array();
+    for (auto& [distance, poi] : chosen.take()) pois.push_back(std::move(poi));
+
+    auto result = wrapResultJson_(lat, lon, radiusMeters, whitelist, std::move(pois), queryInput);
+    result["source"]["poi_store"] = poiStore_->path();
+    reportProjection(result, options_.tags, 0, tagBytesDropped);
+    return result;
+}
+
+std::expected<std::vector<std::size_t>, std::string> PoiOsmClient::storeCounts_(
+    double lat, double lon, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist,
+    const std::vector<PoiWhitelistEntry>& entries) const {
+
+    std::vector<whitelist::Matcher> matchers;
+    for (const auto& entry : entries) matchers.emplace_back(std::vector<PoiWhitelistEntry>{entry});
+
+    // The union first, then each entry
+    std::vector<std::size_t> counts(1 + entries.size(), 0);
+    poiStore_->query(lat, lon, radiusMeters, whitelist, options_.includeWaysAndRelations,
+                     TagProjection(std::nullopt, {}),
+        [&](const OsmElement& element) {
+            ++counts[0];
+            for (std::size_t i = 0; i < matchers.size(); ++i) {
+                if (matchers[i].matches(element.tags)) ++counts[i + 1];
+            }
+        });
+    return counts;
+}
+
+nlohmann::json PoiOsmClient::selectPois_(nlohmann::json pois, const std::vector<double>& distances,
+                                         Selection selection) const {
+    // Cached POIs carry the distance to the center of the query that fetched them
+    PoiSelector<nlohmann::json> chosen(selection.limit, selection.sort);
+    for (std::size_t i = 0; i < pois.size(); ++i) {
+        if (!chosen.accepts(distances[i])) continue;
+        pois[i]["distance_m"] = roundedMeters(distances[i]);
+        chosen.add(distances[i], std::move(pois[i]));
+    }
+
+    nlohmann::json selected = nlohmann::json::array();
+    for (auto& [distance, poi] : chosen.take()) selected.push_back(std::move(poi));
+    return selected;
+}
+
+std::string PoiOsmClient::overpassPostData_(const std::string& query) {
+    // Overpass expects body: data=query
+    return "data=" + pool_->escape(query);
+}
+
+nlohmann::json PoiOsmClient::overpassResult_(
+    const nlohmann::json& elements, std::size_t responseBytes, std::size_t tagBytesDropped,
+    double lat, double lon, int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist,
+    const nlohmann::json& queryInput,
+    Selection selection) const {
+
+    auto result = buildResultJson_(lat, lon, radiusMeters, whitelist, elements, queryInput, selection);
+
+    // A limited result does not hold every POI of its circle
+    if (selection.limit == 0) {
+        resultCache_->store(lat, lon, radiusMeters, whitelist, result["results"]["pois"], responseBytes);
     }
+    reportProjection(result, options_.tags, responseBytes, tagBytesDropped);
+    return result;
 }
 
 std::string PoiOsmClient::buildOverpassQuery_(
     double lat, double lon, int radiusMeters,
     const std::vector<PoiWhitelistEntry>& whitelist) const {
     
-    std::string query = "[out:json][timeout:25];(";
-    
     // Format lat/lon with high precision
-    std::string center = std::format("around:{},{:.6f},{:.6f}", radiusMeters, lat, lon);
+    return buildOverpassAreaQuery_(aroundFilter(lat, lon, radiusMeters), whitelist);
+}
+
+std::string PoiOsmClient::buildOverpassAreaQuery_(
+    const std::string& area,
+    const std::vector<PoiWhitelistEntry>& whitelist,
+    const std::string& exclude) const {
 
-    if (whitelist.empty()) {
-        query += std::format("node({});", center);
+    std::string query = "[out:json][timeout:25];";
+    std::string_view elements = options_.includeWaysAndRelations ? "nwr" : "node";
+
+    auto filters = tagFilters(whitelist);
+    if (filters.size() <= 1) {
+        query += std::format("{}{}{}", elements, area, filters.empty() ? "" : filters.front());
     } else {
-        for (const auto& w : whitelist) {
-            if (w.value.empty()) {
-                query += std::format("node({})[\"{}\"];", center, w.key);
-            } else {
-                // Escape quotes in value if necessary (simple approach)
-                query += std::format("node({})[\"{}\"=\"{}\"];", center, w.key, w.value);
-            }
-        }
+        // Evaluate the area once and let every tag filter reuse the named set
+        query += std::format("{}{}->.inside;(", elements, area);
+        for (const auto& filter : filters) query += std::format("{}.inside{};", elements, filter);
+        query += ")";
+    }
+
+    // The matches of the excluded area are tested within the result only,
+    // and never sent
+    if (exclude.empty()) {
+        query += ";";
+    } else {
+        query += std::format("->.matched;(.matched; - {}.matched{};);", elements, exclude);
     }
 
-    query += ");out center;";
+    // Without tags only ids and positions are needed
+    query += dropsAllTags(options_.tags) ? "out skel center;" : "out center;";
+    return query;
+}
+
+std::string PoiOsmClient::buildOverpassCountQuery_(
+    const std::string& area,
+    const std::vector<PoiWhitelistEntry>& whitelist) const {
+
+    std::string query = "[out:json][timeout:25];";
+    std::string_view elements = options_.includeWaysAndRelations ? "nwr" : "node";
+
+    auto filters = tagFilters(whitelist);
+    auto entries = distinctEntries(whitelist);
+    if (entries.size() <= 1) {
+        query += std::format("{}{}{};out count;", elements, area, filters.empty() ? "" : filters.front());
+        return query;
+    }
+
+    // The union is counted once, so elements matching several entries count once
+    query += std::format("{}{}->.inside;(", elements, area);
+    for (const auto& filter : filters) query += std::format("{}.inside{};", elements, filter);
+    query += ");out count;";
+    for (const auto& w : entries) {
+        std::string filter = w.value.empty() ? std::format("[{}]", qlString(w.key))
+                                             : std::format("[{}={}]", qlString(w.key), qlString(w.value));
+        query += std::format("{}.inside{};out count;", elements, filter);
+    }
     return query;
 }
 
@@ -216,7 +1515,74 @@ nlohmann::json PoiOsmClient::buildResultJson_(
     int radiusMeters,
     const std::vector<PoiWhitelistEntry>& whitelist,
     const nlohmann::json& elements,
-    const nlohmann::json& queryInput) const {
+    const nlohmann::json& queryInput,
+    Selection selection) const {
+
+    static const nlohmann::json noTags = nlohmann::json::object();
+    const whitelist::Matcher matcher(clientWhitelist(whitelist, options_.tags));
+
+    // Union statements, overlapping tiles and split quadrants can all
+    // deliver the same element more than once
+    IdSet seen(elements.size());
+    std::size_t duplicates = 0;
+
+    // Tags are copied once, straight into their POI; everything else is
+    // moved. POIs that limit and sort rule out are never built.
+    PoiSelector<nlohmann::json> chosen(selection.limit, selection.sort);
+    for (const auto& obj : elements) {
+        auto type = obj.find("type");
+        if (type == obj.end() || !type->is_string() ||
+            !isPoiType(type->get_ref<const std::string&>(), options_.includeWaysAndRelations)) {
+            continue;
+        }
+        std::uint64_t id = obj.value("id", std::uint64_t{0});
+        if (!seen.insert(osmKey(type->get_ref<const std::string&>(), id))) {
+            ++duplicates;
+            continue;
+        }
+
+        auto tagsIt = obj.find("tags");
+        const nlohmann::json& tags = tagsIt != obj.end() ? *tagsIt : noTags;
+
+        if (!matcher.matches(tags)) continue;
+
+        auto [lat, lon] = elementPosition(obj);
+        double distance = geo::haversineMeters(centerLat, centerLon, lat, lon);
+        if (!chosen.accepts(distance)) continue;
+
+        nlohmann::json poi;
+        poi["type"] = *type;
+        poi["id"] = id;
+        poi["lat"] = lat;
+        poi["lon"] = lon;
+        poi["distance_m"] = roundedMeters(distance);
+
+        if (auto name = tags.find("name"); name != tags.end()) {
+            poi["name"] = *name;
+        } else {
+            poi["name"] = nullptr;
+        }
+
+        poi["tags"] = tags;
+        chosen.add(distance, std::move(poi));
+    }
+
+    auto selected = chosen.take();
+    nlohmann::json poisArray = nlohmann::json::array();
+    poisArray.get_ref<nlohmann::json::array_t&>().reserve(selected.size());
+    for (auto& [distance, poi] : selected) poisArray.push_back(std::move(poi));
+
+    return wrapResultJson_(centerLat, centerLon, radiusMeters, whitelist, std::move(poisArray), queryInput,
+                           duplicates);
+}
+
+nlohmann::json PoiOsmClient::wrapResultJson_(
+    double centerLat, double centerLon,
+    int radiusMeters,
+    const std::vector<PoiWhitelistEntry>& whitelist,
+    nlohmann::json pois,
+    const nlohmann::json& queryInput,
+    std::size_t duplicatesDropped) const {
 
     nlohmann::json root;
     root["schema_version"] = 1;
@@ -224,7 +1590,7 @@ nlohmann::json PoiOsmClient::buildResultJson_(
     nlohmann::json source;
     source["provider"] = "OpenStreetMap";
     source["geocoder"] = "Nominatim";
-    source["overpass_endpoint"] = "https://overpass-api.de/api/interpreter";
+    source["overpass_endpoint"] = options_.overpassEndpoint;
     root["source"] = source;
 
     nlohmann::json query;
@@ -244,47 +1610,11 @@ nlohmann::json PoiOsmClient::buildResultJson_(
     query["timestamp_utc"] = currentIsoTime();
     root["query"] = query;
 
-    nlohmann::json poisArray = nlohmann::json::array();
-    for (const auto& obj : elements) {
-        if (obj.value("type", "") != "node") continue;
-
-        double lat = obj.value("lat", 0.0);
-        double lon = obj.value("lon", 0.0);
-        nlohmann::json tags = obj.value("tags", nlohmann::json::object());
-
-        bool accepted = whitelist.empty();
-        if (!accepted) {
-            for (const auto& w : whitelist) {
-                if (tags.contains(w.key)) {
-                    std::string val = tags[w.key];
-                    if (w.value.empty() || val == w.value) {
-                        accepted = true;
-                        break;
-                    }
-                }
-            }
-        }
-
-        if (!accepted) continue;
-
-        nlohmann::json poi;
-        poi["lat"] = lat;
-        poi["lon"] = lon;
-        
-        if (tags.contains("name")) {
-            poi["name"] = tags["name"];
-        } else {
-            poi["name"] = nullptr;
-        }
-
-        poi["tags"] = tags;
-        poisArray.push_back(poi);
-    }
-
     nlohmann::json results;
-    results["count"] = poisArray.size();
-    results["pois"] = poisArray;
-    root["results"] = results;
+    results["count"] = pois.size();
+    results["duplicates_dropped"] = duplicatesDropped;
+    results["pois"] = std::move(pois);
+    root["results"] = std::move(results);
 
     return root;
 }
@@ -0,0 +1,188 @@
+/**
+ * SPDX-FileComment: Implementation of the single-threaded coroutine reactor
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file PoiOsmReactor.cpp
+ * @brief  Implements PoiOsmReactor on curl_multi_socket_action and poll().
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "PoiOsmReactor.hpp"
+#include "ReactorFetch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+#include <curl/curl.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#define poll WSAPoll
+#else
+#include <poll.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Upper bound for a single wait when libcurl did not request a timeout
+constexpr int kIdlePollTimeoutMs = 1000;
+
+} // namespace
+
+struct PoiOsmReactor::Impl {
+    CURLM* multi = nullptr;
+    std::unordered_map<curl_socket_t, short> sockets;   // socket -> poll events
+    std::unordered_map<CURL*, FetchAwaiter*> transfers; // easy handle -> awaiter
+    std::optional<Clock::time_point> deadline;
+
+    static int onSocket(CURL*, curl_socket_t socket, int what, void* userp, void*) {
+        auto* impl = static_cast<Impl*>(userp);
+        switch (what) {
+            case CURL_POLL_IN: impl->sockets[socket] = POLLIN; break;
+            case CURL_POLL_OUT: impl->sockets[socket] = POLLOUT; break;
+            case CURL_POLL_INOUT: impl->sockets[socket] = POLLIN | POLLOUT; break;
+            case CURL_POLL_REMOVE: impl->sockets.erase(socket); break;
+            default: break;
+        }
+        return 0;
+    }
+
+    static int onTimer(CURLM*, long timeoutMs, void* userp) {
+        auto* impl = static_cast<Impl*>(userp);
+        if (timeoutMs < 0) {
+            impl->deadline.reset();
+        } else {
+            impl->deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+        }
+        return 0;
+    }
+};
+
+PoiOsmReactor::PoiOsmReactor(long maxConnectionsPerHost) : impl_(std::make_unique<Impl>()) {
+    impl_->multi = curl_multi_init();
+    if (impl_->multi) {
+        curl_multi_setopt(impl_->multi, CURLMOPT_SOCKETFUNCTION, &Impl::onSocket);
+        curl_multi_setopt(impl_->multi, CURLMOPT_SOCKETDATA, impl_.get());
+        curl_multi_setopt(impl_->multi, CURLMOPT_TIMERFUNCTION, &Impl::onTimer);
+        curl_multi_setopt(impl_->multi, CURLMOPT_TIMERDATA, impl_.get());
+        curl_multi_setopt(impl_->multi, CURLMOPT_MAX_HOST_CONNECTIONS, maxConnectionsPerHost);
+    }
+}
+
+PoiOsmReactor::~PoiOsmReactor() {
+    if (!impl_->multi) return;
+    for (auto& [easy, awaiter] : impl_->transfers) curl_multi_remove_handle(impl_->multi, easy);
+    impl_->transfers.clear();
+    curl_multi_cleanup(impl_->multi);
+}
+
+void PoiOsmReactor::run() {
+    while (runOnce_()) {}
+}
+
+bool PoiOsmReactor::runOnce_() {
+    if (impl_->transfers.empty()) return false;
+
+    int timeoutMs = kIdlePollTimeoutMs;
+    if (impl_->deadline) {
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(*impl_->deadline - Clock::now());
+        timeoutMs = static_cast<int>(std::clamp<long long>(remaining.count(), 0, kIdlePollTimeoutMs));
+    }
+
+    std::vector<pollfd> fds;
+    fds.reserve(impl_->sockets.size());
+    for (const auto& [socket, events] : impl_->sockets) fds.push_back(pollfd{socket, events, 0});
+
+    int ready = poll(fds.data(), static_cast<decltype(fds.size())>(fds.size()), timeoutMs);
+
+    int running = 0;
+    if (ready > 0) {
+        for (const auto& fd : fds) {
+            if (fd.revents == 0) continue;
+            int flags = 0;
+            if (fd.revents & POLLIN) flags |= CURL_CSELECT_IN;
+            if (fd.revents & POLLOUT) flags |= CURL_CSELECT_OUT;
+            if (fd.revents & (POLLERR | POLLHUP | POLLNVAL)) flags |= CURL_CSELECT_ERR;
+            curl_multi_socket_action(impl_->multi, fd.fd, flags, &running);
+        }
+    }
+    if (impl_->deadline && Clock::now() >= *impl_->deadline) {
+        impl_->deadline.reset();
+        curl_multi_socket_action(impl_->multi, CURL_SOCKET_TIMEOUT, 0, &running);
+    }
+
+    // Collect first: resumed coroutines may start new transfers
+    std::vector<std::coroutine_handle<>> resumable;
+    int pending = 0;
+    while (CURLMsg* msg = curl_multi_info_read(impl_->multi, &pending)) {
+        if (msg->msg != CURLMSG_DONE) continue;
+        auto it = impl_->transfers.find(msg->easy_handle);
+        if (it == impl_->transfers.end()) continue;
+
+        FetchAwaiter* awaiter = it->second;
+        CURLcode code = msg->data.result;
+        impl_->transfers.erase(it);
+        curl_multi_remove_handle(impl_->multi, msg->easy_handle);
+        resumable.push_back(awaiter->complete(code));
+    }
+    for (auto handle : resumable) handle.resume();
+
+    return true;
+}
+
+PoiOsmReactor::FetchAwaiter PoiOsmReactor::fetch_(CurlPool& pool, std::string url, std::string postData,
+                                                  std::function<bool(std::string_view)> sink) {
+    return FetchAwaiter(*this, pool.acquire(), std::move(url), std::move(postData), std::move(sink));
+}
+
+bool PoiOsmReactor::FetchAwaiter::await_suspend(std::coroutine_handle<> awaiter) {
+    CURL* easy = handle_.get();
+    if (!easy) {
+        result_ = std::unexpected("Failed to initialize CURL");
+        return false;
+    }
+    if (!reactor_.impl_->multi) {
+        result_ = std::unexpected("Failed to initialize CURL multi handle");
+        return false;
+    }
+
+    curl_easy_setopt(easy, CURLOPT_URL, url_.c_str());
+    if (sink_) {
+        curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, &CurlPool::writeToSink);
+        curl_easy_setopt(easy, CURLOPT_WRITEDATA, &sink_);
+    } else {
+        curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, &CurlPool::appendToString);
+        curl_easy_setopt(easy, CURLOPT_WRITEDATA, &body_);
+    }
+    if (!postData_.empty()) {
+        curl_easy_setopt(easy, CURLOPT_POSTFIELDS, postData_.c_str());
+    }
+
+    if (curl_multi_add_handle(reactor_.impl_->multi, easy) != CURLM_OK) {
+        result_ = std::unexpected("Failed to add request to CURL multi handle");
+        return false;
+    }
+
+    awaiter_ = awaiter;
+    reactor_.impl_->transfers.emplace(easy, this);
+    return true;
+}
+
+std::coroutine_handle<> PoiOsmReactor::FetchAwaiter::complete(CURLcode code) {
+    if (auto status = CurlPool::checkResult(handle_.get(), code); !status) {
+        result_ = std::unexpected(status.error());
+    } else {
+        result_ = std::move(body_);
+    }
+    return awaiter_;
+}
@@ -0,0 +1,137 @@
+/**
+ * SPDX-FileComment: Implementation of the typed POI result
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file PoiResult.cpp
+ * @brief Implements PoiResult and PoiResultBuilder.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "PoiResult.hpp"
+#include "PoiResultBuilder.hpp"
+
+#include <cmath>
+
+namespace {
+
+PoiElementType elementType(std::string_view type) {
+    if (type == "way") return PoiElementType::Way;
+    if (type == "relation") return PoiElementType::Relation;
+    return PoiElementType::Node;
+}
+
+} // namespace
+
+std::string_view toString(PoiElementType type) {
+    switch (type) {
+    case PoiElementType::Way: return "way";
+    case PoiElementType::Relation: return "relation";
+    default: return "node";
+    }
+}
+
+std::optional<std::string_view> PoiResult::tag(const Poi& poi, std::string_view key) const {
+    for (const auto& t : tags(poi)) {
+        if (str(t.key) == key) return str(t.value);
+    }
+    return std::nullopt;
+}
+
+nlohmann::json PoiResult::poiJson(const Poi& poi) const {
+    nlohmann::json json;
+    json["type"] = toString(poi.type);
+    json["id"] = poi.id;
+    json["lat"] = poi.lat;
+    json["lon"] = poi.lon;
+    json["distance_m"] = std::round(poi.distance * 10.0) / 10.0;
+    if (poi.name.length > 0) {
+        json["name"] = name(poi);
+    } else {
+        json["name"] = nullptr;
+    }
+
+    nlohmann::json tagObject = nlohmann::json::object();
+    for (const auto& t : tags(poi)) tagObject[std::string(str(t.key))] = str(t.value);
+    json["tags"] = std::move(tagObject);
+    return json;
+}
+
+nlohmann::json PoiResult::toJson() const {
+    nlohmann::json root = envelope_;
+
+    nlohmann::json poisArray = nlohmann::json::array();
+    for (const auto& poi : pois_) poisArray.push_back(poiJson(poi));
+
+    nlohmann::json results;
+    results["count"] = pois_.size();
+    results["duplicates_dropped"] = duplicatesDropped_;
+    results["pois"] = std::move(poisArray);
+    root["results"] = std::move(results);
+    return root;
+}
+
+PoiResultBuilder::PoiResultBuilder(nlohmann::json envelope, std::size_t duplicatesDropped) {
+    result_.envelope_ = std::move(envelope);
+    result_.duplicatesDropped_ = duplicatesDropped;
+}
+
+bool PoiResultBuilder::admit(std::string_view type, std::uint64_t id) {
+    if (seen_.insert(osmKey(type, id))) return true;
+    ++result_.duplicatesDropped_;
+    return false;
+}
+
+void PoiResultBuilder::add(const OsmElement& element, double distance) {
+    Poi poi;
+    poi.type = elementType(element.type);
+    poi.id = element.id;
+    poi.lat = element.lat;
+    poi.lon = element.lon;
+    poi.distance = distance;
+    poi.firstTag = static_cast<std::uint32_t>(result_.tags_.size());
+    for (const auto& [key, value] : element.tags) addTag_(poi, key, value);
+    result_.pois_.push_back(poi);
+}
+
+void PoiResultBuilder::add(const nlohmann::json& json) {
+    Poi poi;
+    poi.type = elementType(json.value("type", "node"));
+    poi.id = json.value("id", std::uint64_t{0});
+    poi.lat = json.value("lat", 0.0);
+    poi.lon = json.value("lon", 0.0);
+    poi.distance = json.value("distance_m", 0.0);
+    poi.firstTag = static_cast<std::uint32_t>(result_.tags_.size());
+    if (auto tags = json.find("tags"); tags != json.end()) {
+        for (const auto& [key, value] : tags->items()) {
+            addTag_(poi, key, value.is_string() ? value.get_ref<const std::string&>() : value.dump());
+        }
+    }
+    result_.pois_.push_back(poi);
+}
+
+PoiResult PoiResultBuilder::finish() {
+    return std::move(result_);
+}
+
+PoiString PoiResultBuilder::intern_(std::string_view s) {
+    if (auto it = interned_.find(s); it != interned_.end()) return it->second;
+
+    PoiString stored{static_cast<std::uint32_t>(result_.arena_.size()), static_cast<std::uint32_t>(s.size())};
+    result_.arena_.append(s);
+    interned_.emplace(s, stored);
+    return stored;
+}
+
+void PoiResultBuilder::addTag_(Poi& poi, std::string_view key, std::string_view value) {
+    PoiTag tag{intern_(key), intern_(value)};
+    if (key == "name") poi.name = tag.value;
+    result_.tags_.push_back(tag);
+    ++poi.tagCount;
+}
@@ -0,0 +1,78 @@
+/**
+ * SPDX-FileComment: Internal header for assembling typed POI results
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file PoiResultBuilder.hpp
+ * @brief Defines the PoiResultBuilder class, which fills a PoiResult and
+ * interns its strings.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+#include "IdSet.hpp"
+#include "OverpassStream.hpp"
+#include "PoiResult.hpp"
+
+/**
+ * @brief Appends POIs to a PoiResult, storing each distinct string once.
+ *
+ * The intern table only lives while the result is built. Its nodes are
+ * carved from a monotonic arena and freed together with the builder.
+ */
+class PoiResultBuilder {
+public:
+    /**
+     * @brief Starts a result.
+     *
+     * @param envelope The result document without `results` (source, query).
+     * @param duplicatesDropped Duplicates already dropped before the POIs reach the builder.
+     */
+    explicit PoiResultBuilder(nlohmann::json envelope, std::size_t duplicatesDropped = 0);
+
+    /**
+     * @brief Registers an element before it is added.
+     *
+     * @return bool false if the element was seen before; it is then counted as a dropped duplicate.
+     */
+    bool admit(std::string_view type, std::uint64_t id);
+
+    /// Appends a POI parsed from an Overpass response, @p distance meters from the query center.
+    void add(const OsmElement& element, double distance);
+
+    /// Appends a POI given in the layout of the result JSON's `results.pois`.
+    void add(const nlohmann::json& poi);
+
+    /// The result JSON without `results`, for metadata known only after the fetch.
+    nlohmann::json& envelope() { return result_.envelope_; }
+
+    /// Hands out the finished result; the builder must not be used afterwards.
+    PoiResult finish();
+
+private:
+    struct StringHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    PoiString intern_(std::string_view s);
+    void addTag_(Poi& poi, std::string_view key, std::string_view value);
+
+    PoiResult result_;
+    IdSet seen_;
+    std::pmr::monotonic_buffer_resource arena_;
+    std::pmr::unordered_map<std::pmr::string, PoiString, StringHash, std::equal_to<>> interned_{&arena_};
+};
@@ -0,0 +1,100 @@
+/**
+ * SPDX-FileComment: Internal header for choosing the POIs of a result
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file PoiSelector.hpp
+ * @brief Defines PoiSelector, which applies PoiOsmClientOptions::limit and
+ * ::sort while POIs are produced.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "PoiOsm.hpp"
+
+/**
+ * @brief Chooses the POIs of a result as they arrive.
+ *
+ * Without a limit every POI is kept. With a limit and no sorting the first
+ * @c limit POIs are kept. With PoiSortOrder::Distance and a limit, the
+ * @c limit nearest POIs are kept in a bounded max-heap, so memory stays
+ * O(limit) however many POIs are offered. Equal distances keep their
+ * arrival order.
+ *
+ * @tparam T The POI representation.
+ */
+template <typename T>
+class PoiSelector {
+public:
+    PoiSelector(std::size_t limit, PoiSortOrder sort) : limit_(limit), byDistance_(sort == PoiSortOrder::Distance) {}
+
+    /**
+     * @brief Checks whether a POI at @p distance would be kept.
+     *
+     * Lets callers skip building POIs that add() would discard.
+     */
+    bool accepts(double distance) const {
+        if (limit_ == 0 || items_.size() < limit_) return true;
+        return byDistance_ && distance < items_.front().distance;
+    }
+
+    /**
+     * @brief Offers a POI.
+     *
+     * @param distance Distance from the query center in meters.
+     * @param item The POI.
+     */
+    void add(double distance, T item) {
+        if (!accepts(distance)) return;
+
+        bool bounded = byDistance_ && limit_ != 0;
+        if (bounded && items_.size() == limit_) {
+            std::ranges::pop_heap(items_, before_);
+            items_.pop_back();
+        }
+        items_.push_back({distance, sequence_++, std::move(item)});
+        if (bounded) std::ranges::push_heap(items_, before_);
+    }
+
+    /**
+     * @brief Hands out the chosen POIs, nearest first when sorting by distance.
+     */
+    std::vector<std::pair<double, T>> take() {
+        if (byDistance_) std::ranges::sort(items_, before_);
+
+        std::vector<std::pair<double, T>> chosen;
+        chosen.reserve(items_.size());
+        for (auto& entry : items_) chosen.emplace_back(entry.distance, std::move(entry.item));
+        items_.clear();
+        return chosen;
+    }
+
+private:
+    struct Entry {
+        double distance;
+        std::uint64_t sequence;
+        T item;
+    };
+
+    static constexpr auto before_ = [](const Entry& a, const Entry& b) {
+        return a.distance != b.distance ? a.distance < b.distance : a.sequence < b.sequence;
+    };
+
+    std::size_t limit_;
+    bool byDistance_;
+    std::uint64_t sequence_ = 0;
+    std::vector<Entry> items_; // a max-heap by distance while bounded
+};
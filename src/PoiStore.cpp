@@ -0,0 +1,245 @@
+/**
+ * SPDX-FileComment: Implementation of the offline POI store
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file PoiStore.cpp
+ * @brief Implements opening and querying PoiStore files.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "PoiStore.hpp"
+#include "Tiles.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <format>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace {
+
+using poistore::Header;
+
+std::string errnoText() {
+    return std::strerror(errno);
+}
+
+// Size of each section, from the counts of the header
+std::array<std::uint64_t, poistore::kSectionCount> sectionSizes(const Header& header) {
+    std::array<std::uint64_t, poistore::kSectionCount> sizes{};
+    sizes[poistore::kIds] = header.recordCount * sizeof(std::uint64_t);
+    sizes[poistore::kLatitudes] = header.recordCount * sizeof(std::int32_t);
+    sizes[poistore::kLongitudes] = header.recordCount * sizeof(std::int32_t);
+    sizes[poistore::kTagRanges] = (header.recordCount + 1) * sizeof(std::uint32_t);
+    sizes[poistore::kTypes] = header.recordCount;
+    sizes[poistore::kTags] = header.tagCount * 2 * sizeof(std::uint32_t);
+    sizes[poistore::kKeys] = header.keyCount * sizeof(std::uint32_t);
+    sizes[poistore::kCells] = header.cellCount * sizeof(poistore::Cell);
+    sizes[poistore::kStringOffsets] = (header.stringCount + 1) * sizeof(std::uint32_t);
+    sizes[poistore::kStrings] = header.stringBytes;
+    return sizes;
+}
+
+} // namespace
+
+std::expected<std::unique_ptr<PoiStore>, std::string> PoiStore::open(const std::string& path) {
+    std::unique_ptr<PoiStore> store(new PoiStore(path));
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return std::unexpected(std::format("Cannot open POI store {}: {}", path, errnoText()));
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return std::unexpected(std::format("Cannot read POI store {}: {}", path, errnoText()));
+    }
+    store->size_ = static_cast<std::size_t>(st.st_size);
+    if (store->size_ >= sizeof(Header)) {
+        // Shared and read-only: every process that maps the store uses the same page cache
+        void* data = ::mmap(nullptr, store->size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            return std::unexpected(std::format("Cannot map POI store {}: {}", path, errnoText()));
+        }
+        store->data_ = static_cast<const char*>(data);
+    }
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return std::unexpected(std::format("Cannot open POI store {}: {}", path, errnoText()));
+    store->size_ = static_cast<std::size_t>(in.tellg());
+    store->buffer_ = std::make_unique<std::uint64_t[]>(store->size_ / sizeof(std::uint64_t) + 1);
+    in.seekg(0);
+    if (!in.read(reinterpret_cast<char*>(store->buffer_.get()), static_cast<std::streamsize>(store->size_))) {
+        return std::unexpected(std::format("Cannot read POI store {}: {}", path, errnoText()));
+    }
+    store->data_ = reinterpret_cast<const char*>(store->buffer_.get());
+#endif
+
+    Header header;
+    if (store->size_ < sizeof(header)) return std::unexpected(std::format("Not a POI store: {}", path));
+    std::memcpy(&header, store->data_, sizeof(header));
+    if (std::memcmp(header.magic, poistore::kMagic, sizeof(poistore::kMagic)) != 0) {
+        return std::unexpected(std::format("Not a POI store: {}", path));
+    }
+    if (header.version != poistore::kFormatVersion) {
+        return std::unexpected(std::format("Unsupported POI store version {} in {}", header.version, path));
+    }
+    if (header.cellsPerDegree == 0 || header.cellsPerDegree > poistore::kMaxCellsPerDegree) {
+        return std::unexpected(std::format("Corrupt POI store: {}", path));
+    }
+
+    // Only the section bounds are checked here; nothing is scanned. No count
+    // can exceed the file size, which also keeps the section sizes from overflowing.
+    for (std::uint64_t count : {header.recordCount, header.tagCount, header.keyCount, header.cellCount,
+                                header.stringCount, header.stringBytes}) {
+        if (count > store->size_) return std::unexpected(std::format("Truncated POI store: {}", path));
+    }
+    auto sizes = sectionSizes(header);
+    for (std::uint32_t i = 0; i < poistore::kSectionCount; ++i) {
+        std::uint64_t offset = header.sections[i];
+        if (offset % 8 != 0 || offset < sizeof(Header)) {
+            return std::unexpected(std::format("Corrupt POI store: {}", path));
+        }
+        if (offset > store->size_ || sizes[i] > store->size_ - offset) {
+            return std::unexpected(std::format("Truncated POI store: {}", path));
+        }
+    }
+
+    auto section = [&](poistore::Section s) { return store->data_ + header.sections[s]; };
+    store->south_ = header.south;
+    store->west_ = header.west;
+    store->north_ = header.north;
+    store->east_ = header.east;
+    store->waysAndRelations_ = (header.flags & poistore::kFlagWaysAndRelations) != 0;
+    store->cellsPerDegree_ = header.cellsPerDegree;
+    store->recordCount_ = header.recordCount;
+    store->ids_ = reinterpret_cast<const std::uint64_t*>(section(poistore::kIds));
+    store->lats_ = reinterpret_cast<const std::int32_t*>(section(poistore::kLatitudes));
+    store->lons_ = reinterpret_cast<const std::int32_t*>(section(poistore::kLongitudes));
+    store->tagRanges_ = reinterpret_cast<const std::uint32_t*>(section(poistore::kTagRanges));
+    store->types_ = reinterpret_cast<const std::uint8_t*>(section(poistore::kTypes));
+    store->tags_ = reinterpret_cast<const std::uint32_t*>(section(poistore::kTags));
+    store->tagCount_ = header.tagCount;
+    store->cells_ = reinterpret_cast<const poistore::Cell*>(section(poistore::kCells));
+    store->cellCount_ = header.cellCount;
+    store->stringOffsets_ = reinterpret_cast<const std::uint32_t*>(section(poistore::kStringOffsets));
+    store->stringCount_ = header.stringCount;
+    store->strings_ = section(poistore::kStrings);
+    store->stringBytes_ = header.stringBytes;
+    store->index_ = GridIndex(store->lats_, store->lons_, store->recordCount_, store->cells_, store->cellCount_,
+                              store->cellsPerDegree_);
+
+    const auto* keys = reinterpret_cast<const std::uint32_t*>(section(poistore::kKeys));
+    for (std::size_t i = 0; i < header.keyCount; ++i) store->keys_.emplace(store->string_(keys[i]));
+    return store;
+}
+
+PoiStore::PoiStore(std::string path) : path_(std::move(path)) {}
+
+PoiStore::~PoiStore() {
+#ifndef _WIN32
+    if (data_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+bool PoiStore::covers(double lat, double lon, int radiusMeters) const {
+    // A circle crossing the antimeridian must be covered on both sides of it
+    auto pieces = tiles::splitAntimeridian(tiles::circleBounds(lat, lon, radiusMeters));
+    return std::ranges::all_of(pieces, [this](const tiles::BBox& box) {
+        return box.south >= south_ && box.north <= north_ && box.west >= west_ && box.east <= east_;
+    });
+}
+
+bool PoiStore::answers(const std::vector<PoiWhitelistEntry>& whitelist) const {
+    // An empty whitelist asks for every tagged element
+    if (keys_.empty()) return true;
+    if (whitelist.empty()) return false;
+    return std::ranges::all_of(whitelist, [this](const auto& entry) { return keys_.contains(entry.key); });
+}
+
+std::size_t PoiStore::query(double lat, double lon, int radiusMeters,
+                            const std::vector<PoiWhitelistEntry>& whitelist,
+                            bool waysAndRelations,
+                            const TagProjection& projection,
+                            const OverpassStream::Sink& sink) const {
+    const whitelist::Matcher matcher(whitelist);
+    std::array<std::byte, 4096> buffer;
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+    std::size_t tagBytesDropped = 0;
+    index_.circle(lat, lon, radiusMeters, [&](std::size_t i, double) {
+        arena.release();
+        emit_(i, waysAndRelations, matcher, projection, &arena, tagBytesDropped, sink);
+    });
+    return tagBytesDropped;
+}
+
+std::size_t PoiStore::nearest(double lat, double lon, std::size_t count, int maxRadiusMeters,
+                              const std::vector<PoiWhitelistEntry>& whitelist,
+                              bool waysAndRelations,
+                              const TagProjection& projection,
+                              const OverpassStream::Sink& sink) const {
+    const whitelist::Matcher matcher(whitelist);
+    std::array<std::byte, 4096> buffer;
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+    std::size_t tagBytesDropped = 0;
+    index_.nearest(lat, lon, count, maxRadiusMeters, [&](std::size_t i, double) {
+        arena.release();
+        return emit_(i, waysAndRelations, matcher, projection, &arena, tagBytesDropped, sink);
+    });
+    return tagBytesDropped;
+}
+
+bool PoiStore::emit_(std::size_t i, bool waysAndRelations, const whitelist::Matcher& matcher,
+                     const TagProjection& projection, std::pmr::memory_resource* arena,
+                     std::size_t& tagBytesDropped, const OverpassStream::Sink& sink) const {
+    static constexpr std::array<std::string_view, 3> kTypeNames = {"node", "way", "relation"};
+    std::uint8_t type = types_[i];
+    if (type > poistore::kRelation || (type != poistore::kNode && !waysAndRelations)) return false;
+
+    OsmElement element(arena);
+    element.type = kTypeNames[type];
+    element.hasCenter = type != poistore::kNode;
+    element.id = ids_[i];
+    element.lat = lats_[i] * poistore::kCoordinateUnit;
+    element.lon = lons_[i] * poistore::kCoordinateUnit;
+    std::size_t firstTag = std::min<std::size_t>(tagRanges_[i], tagCount_);
+    std::size_t lastTag = std::clamp<std::size_t>(tagRanges_[i + 1], firstTag, tagCount_);
+    element.tags.reserve(lastTag - firstTag);
+    for (std::size_t t = firstTag; t < lastTag; ++t) {
+        element.tags.emplace_back(string_(tags_[2 * t]), string_(tags_[2 * t + 1]));
+    }
+    if (!matcher.matches(element.tags)) return false;
+
+    std::erase_if(element.tags, [&](const auto& tag) {
+        if (projection.keeps(tag.first)) return false;
+        tagBytesDropped += tag.first.size() + tag.second.size();
+        return true;
+    });
+    sink(element);
+    return true;
+}
+
+std::string_view PoiStore::string_(std::uint32_t index) const {
+    if (index >= stringCount_) return {};
+    std::size_t first = stringOffsets_[index];
+    std::size_t last = stringOffsets_[index + 1];
+    if (first > last || last > stringBytes_) return {};
+    return {strings_ + first, last - first};
+}
@@ -0,0 +1,172 @@
+/**
+ * SPDX-FileComment: Internal header for the offline POI store
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file PoiStore.hpp
+ * @brief Defines the PoiStore class, a compact binary file of the POIs of an
+ * OpenStreetMap extract that answers radius queries offline.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <unordered_set>
+#include <vector>
+
+#include "GridIndex.hpp"
+#include "OverpassStream.hpp"
+#include "PoiOsm.hpp"
+#include "PoiStoreFormat.hpp"
+#include "TagProjection.hpp"
+#include "Whitelist.hpp"
+
+/**
+ * @brief Read-only POI store built once from a `.osm.pbf` extract.
+ *
+ * The file layout is described in PoiStoreFormat.hpp; PoiStoreBuilder
+ * writes it. Ways and relations are stored at their center.
+ *
+ * The file is memory-mapped read-only and queried in place: opening reads
+ * only the header and the list of imported keys, so even a store of
+ * several gigabytes opens in milliseconds, and processes that open the
+ * same store share its pages in the page cache. The cell section is the
+ * directory of a GridIndex over the coordinate columns: a query walks the
+ * Hilbert-ordered cells its circle touches and checks the distance of
+ * their POIs only, and nearest() searches outwards from the center.
+ * Indices read from the file are checked as they are followed, so a
+ * corrupt store cannot make a query read outside the mapping.
+ */
+class PoiStore {
+public:
+    /**
+     * @brief Opens a store written by PoiStoreBuilder.
+     *
+     * @param path Path of the store.
+     * @return std::expected<std::unique_ptr<PoiStore>, std::string> The store or an error message.
+     */
+    static std::expected<std::unique_ptr<PoiStore>, std::string> open(const std::string& path);
+
+    ~PoiStore();
+
+    PoiStore(const PoiStore&) = delete;
+    PoiStore& operator=(const PoiStore&) = delete;
+
+    /// Path the store was opened from.
+    const std::string& path() const { return path_; }
+
+    /// Number of POIs in the store.
+    std::size_t size() const { return recordCount_; }
+
+    /// Whether the store holds ways and relations as well as nodes.
+    bool hasWaysAndRelations() const { return waysAndRelations_; }
+
+    /**
+     * @brief Checks whether a circle lies within the extract.
+     *
+     * Only then does the store know every POI of the circle.
+     */
+    bool covers(double lat, double lon, int radiusMeters) const;
+
+    /**
+     * @brief Checks whether the import kept every POI a whitelist can match.
+     *
+     * A store imported with a restricted set of keys only answers whitelists
+     * whose entries all use one of those keys.
+     */
+    bool answers(const std::vector<PoiWhitelistEntry>& whitelist) const;
+
+    /**
+     * @brief Hands the POIs of a circle that match a whitelist to a sink.
+     *
+     * The whitelist is matched against all tags of a POI; the projection is
+     * applied afterwards.
+     *
+     * @param lat Latitude of the center.
+     * @param lon Longitude of the center.
+     * @param radiusMeters Radius of the circle.
+     * @param whitelist POIs must match it; empty accepts all.
+     * @param waysAndRelations Whether ways and relations are handed on too.
+     * @param projection Tags to hand to the sink.
+     * @param sink Receiver of the POIs.
+     * @return std::size_t Bytes of tag keys and values the projection dropped.
+     */
+    std::size_t query(double lat, double lon, int radiusMeters,
+                      const std::vector<PoiWhitelistEntry>& whitelist,
+                      bool waysAndRelations,
+                      const TagProjection& projection,
+                      const OverpassStream::Sink& sink) const;
+
+    /**
+     * @brief Hands the nearest POIs that match a whitelist to a sink, nearest first.
+     *
+     * @param lat Latitude of the center.
+     * @param lon Longitude of the center.
+     * @param count Number of POIs wanted.
+     * @param maxRadiusMeters POIs farther away are not considered.
+     * @param whitelist POIs must match it; empty accepts all.
+     * @param waysAndRelations Whether ways and relations are handed on too.
+     * @param projection Tags to hand to the sink.
+     * @param sink Receiver of the POIs.
+     * @return std::size_t Bytes of tag keys and values the projection dropped.
+     */
+    std::size_t nearest(double lat, double lon, std::size_t count, int maxRadiusMeters,
+                        const std::vector<PoiWhitelistEntry>& whitelist,
+                        bool waysAndRelations,
+                        const TagProjection& projection,
+                        const OverpassStream::Sink& sink) const;
+
+private:
+    explicit PoiStore(std::string path);
+
+    // Builds POI @p i in @p arena and hands it to @p sink if it matches;
+    // returns whether it did
+    bool emit_(std::size_t i, bool waysAndRelations, const whitelist::Matcher& matcher,
+               const TagProjection& projection, std::pmr::memory_resource* arena, std::size_t& tagBytesDropped,
+               const OverpassStream::Sink& sink) const;
+
+    std::string_view string_(std::uint32_t index) const;
+
+    std::string path_;
+    const char* data_ = nullptr; // the mapped file
+    std::size_t size_ = 0;
+    std::unique_ptr<std::uint64_t[]> buffer_; // holds the file where it is read instead of mapped
+
+    double south_ = 0.0;
+    double west_ = 0.0;
+    double north_ = 0.0;
+    double east_ = 0.0;
+    bool waysAndRelations_ = false;
+    std::uint32_t cellsPerDegree_ = 0;
+    std::unordered_set<std::string_view> keys_; // views into the file
+
+    std::size_t recordCount_ = 0;
+    const std::uint64_t* ids_ = nullptr;
+    const std::int32_t* lats_ = nullptr;
+    const std::int32_t* lons_ = nullptr;
+    const std::uint32_t* tagRanges_ = nullptr;
+    const std::uint8_t* types_ = nullptr;
+    const std::uint32_t* tags_ = nullptr;
+    std::size_t tagCount_ = 0;
+    const poistore::Cell* cells_ = nullptr;
+    std::size_t cellCount_ = 0;
+    const std::uint32_t* stringOffsets_ = nullptr;
+    std::size_t stringCount_ = 0;
+    const char* strings_ = nullptr;
+    std::size_t stringBytes_ = 0;
+    GridIndex index_;
+};
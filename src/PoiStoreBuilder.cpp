@@ -0,0 +1,571 @@
+/**
+ * SPDX-FileComment: Implementation of the POI store import
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file PoiStoreBuilder.cpp
+ * @brief Implements the passes of PoiStoreBuilder.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "PoiStoreBuilder.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <span>
+#include <thread>
+#include <utility>
+
+namespace {
+
+using OwnedTags = std::vector<std::pair<std::string, std::string>>;
+
+OwnedTags ownedTags(const pbf::Tags& tags) {
+    OwnedTags owned;
+    owned.reserve(tags.size());
+    for (const auto& [key, value] : tags) owned.emplace_back(key, value);
+    return owned;
+}
+
+// What the scan keeps of one blob; the strings are copied out of the block
+struct BlobScan {
+    struct Node {
+        std::int64_t id;
+        double lat;
+        double lon;
+        OwnedTags tags;
+    };
+    struct Way {
+        std::int64_t id;
+        OwnedTags tags;
+        std::vector<std::int64_t> refs;
+    };
+    struct Relation {
+        std::int64_t id;
+        OwnedTags tags;
+        std::vector<std::pair<pbf::MemberType, std::int64_t>> members;
+    };
+
+    std::uint64_t offset = 0;
+    bool header = false;
+    std::optional<pbf::Bounds> bounds;
+    std::uint8_t kinds = 0;
+    std::int64_t minNodeId = std::numeric_limits<std::int64_t>::max();
+    std::int64_t maxNodeId = std::numeric_limits<std::int64_t>::min();
+    double south = 90.0;
+    double west = 180.0;
+    double north = -90.0;
+    double east = -180.0;
+    std::uint64_t nodes = 0;
+    std::uint64_t ways = 0;
+    std::uint64_t relations = 0;
+    std::vector<Node> poiNodes;
+    std::vector<Way> poiWays;
+    std::vector<Relation> poiRelations;
+};
+
+// Node ids of the ways a relation pass looks for
+using WayRefs = std::vector<std::pair<std::int64_t, std::vector<std::int64_t>>>;
+
+// Positions of needed nodes found in one blob
+using NodePositions = std::vector<std::tuple<std::int64_t, double, double>>;
+
+// Spilled node ids read back at a time
+constexpr std::size_t kRefBlock = std::size_t{1} << 16;
+
+} // namespace
+
+void PoiStoreBuilder::Geometry::add(double lat, double lon) {
+    south = std::min(south, lat);
+    north = std::max(north, lat);
+    west = std::min(west, lon);
+    east = std::max(east, lon);
+}
+
+void PoiStoreBuilder::Geometry::add(const Geometry& other) {
+    if (!other.resolved()) return;
+    add(other.south, other.west);
+    add(other.north, other.east);
+}
+
+PoiStoreBuilder::PoiStoreBuilder(PoiImportOptions options)
+    : options_(std::move(options)),
+      threads_(options_.threads != 0 ? options_.threads : std::max(std::thread::hardware_concurrency(), 1u)) {
+    keys_.insert(options_.keys.begin(), options_.keys.end());
+}
+
+PoiStoreBuilder::~PoiStoreBuilder() {
+    if (!refsPath_.empty()) std::remove(refsPath_.c_str());
+    if (!pendingPath_.empty()) std::remove(pendingPath_.c_str());
+}
+
+std::expected<PoiImportStats, std::string> PoiStoreBuilder::build(const std::string& pbfPath,
+                                                                  const std::string& storePath) {
+    auto started = std::chrono::steady_clock::now();
+    stats_ = PoiImportStats{};
+    stats_.threads = threads_;
+
+    auto file = pbf::PbfFile::open(pbfPath);
+    if (!file) return std::unexpected(file.error());
+
+    // Half of the budget buffers records, a quarter the node ids of ways and
+    // relations, a quarter resolves node positions
+    PoiStoreWriter writer(storePath, options_.memoryBudget / 2);
+    refsPath_ = storePath + ".refs";
+    pendingPath_ = storePath + ".pending";
+    refBufferBytes_ = options_.memoryBudget / 4;
+    auto fail = [&](const std::string& error) {
+        return std::unexpected(std::format("Cannot import {}: {}", pbfPath, error));
+    };
+
+    if (auto status = scan_(*file, writer); !status) return fail(status.error());
+    if (!sawHeader_) return fail("not an OSM PBF file");
+    if (auto status = collectMemberWays_(*file); !status) return fail(status.error());
+    if (auto status = resolveNodes_(*file); !status) return fail(status.error());
+    if (auto status = writePending_(writer); !status) return fail(status.error());
+
+    poistore::Header header{};
+    header.flags = options_.waysAndRelations ? poistore::kFlagWaysAndRelations : 0;
+    pbf::Bounds bounds = bounds_.value_or(pbf::Bounds{extent_.south, extent_.west, extent_.north, extent_.east});
+    header.south = bounds.south;
+    header.west = bounds.west;
+    header.north = bounds.north;
+    header.east = bounds.east;
+
+    std::vector<std::uint32_t> keys;
+    for (const auto& key : options_.keys) keys.push_back(writer.intern(key));
+    std::ranges::sort(keys);
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    auto written = writer.finish(header, keys);
+    if (!written) return std::unexpected(written.error());
+
+    stats_.spilledRuns = writer.runs();
+    stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return stats_;
+}
+
+template <typename Result>
+std::expected<void, std::string> PoiStoreBuilder::runPass_(pbf::PbfFile& file,
+                                                           const std::vector<std::uint64_t>* offsets,
+                                                           typename BlobPipeline<Result>::Decode decode,
+                                                           typename BlobPipeline<Result>::Consume consume) {
+    ++stats_.passes;
+    BlobPipeline<Result> pipeline(threads_, std::move(decode), std::move(consume));
+
+    // Reading stays on this thread; the file is read sequentially or, for
+    // later passes, only at the offsets of the blobs that matter
+    std::size_t next = 0;
+    while (true) {
+        std::expected<std::optional<pbf::RawBlob>, std::string> blob;
+        if (!offsets) {
+            blob = file.next();
+        } else if (next < offsets->size()) {
+            auto at = file.readAt((*offsets)[next++]);
+            if (at) blob = std::move(*at);
+            else blob = std::unexpected(at.error());
+        } else {
+            blob = std::nullopt;
+        }
+        if (!blob) {
+            (void)pipeline.finish();
+            return std::unexpected(blob.error());
+        }
+        if (!*blob) break;
+
+        ++stats_.blobReads;
+        if (!pipeline.submit(std::move(**blob))) break;
+    }
+    return pipeline.finish();
+}
+
+std::expected<void, std::string> PoiStoreBuilder::scan_(pbf::PbfFile& file, PoiStoreWriter& writer) {
+    bool waysAndRelations = options_.waysAndRelations;
+    auto decode = [this, waysAndRelations](const pbf::RawBlob& blob) -> std::expected<BlobScan, std::string> {
+        auto data = pbf::blobData(blob.blob);
+        if (!data) return std::unexpected(data.error());
+
+        BlobScan scan;
+        scan.offset = blob.offset;
+        if (blob.type == "OSMHeader") {
+            auto bounds = pbf::decodeHeader(*data);
+            if (!bounds) return std::unexpected(bounds.error());
+            scan.header = true;
+            scan.bounds = *bounds;
+            return scan;
+        }
+        if (blob.type != "OSMData") return scan;
+
+        pbf::BlockHandler handler;
+        handler.node = [&](const pbf::Node& node) {
+            scan.kinds |= kHasNodes;
+            ++scan.nodes;
+            scan.minNodeId = std::min(scan.minNodeId, node.id);
+            scan.maxNodeId = std::max(scan.maxNodeId, node.id);
+            scan.south = std::min(scan.south, node.lat);
+            scan.north = std::max(scan.north, node.lat);
+            scan.west = std::min(scan.west, node.lon);
+            scan.east = std::max(scan.east, node.lon);
+            if (relevant_(node.tags)) scan.poiNodes.push_back({node.id, node.lat, node.lon, ownedTags(node.tags)});
+        };
+        if (waysAndRelations) {
+            handler.way = [&](const pbf::Way& way) {
+                scan.kinds |= kHasWays;
+                ++scan.ways;
+                if (relevant_(way.tags)) scan.poiWays.push_back({way.id, ownedTags(way.tags), way.refs});
+            };
+            handler.relation = [&](const pbf::Relation& relation) {
+                ++scan.relations;
+                if (relevant_(relation.tags)) {
+                    scan.poiRelations.push_back({relation.id, ownedTags(relation.tags), relation.members});
+                }
+            };
+        }
+        if (auto status = pbf::decodeBlock(*data, handler); !status) return std::unexpected(status.error());
+        return scan;
+    };
+
+    std::vector<std::uint32_t> tags;
+    auto intern = [&](const OwnedTags& owned) {
+        tags.clear();
+        for (const auto& [key, value] : owned) {
+            tags.push_back(writer.intern(key));
+            tags.push_back(writer.intern(value));
+        }
+    };
+
+    auto consume = [&](BlobScan scan) -> std::expected<void, std::string> {
+        if (scan.header) {
+            sawHeader_ = true;
+            bounds_ = scan.bounds;
+            ++stats_.blobs;
+            return {};
+        }
+        ++stats_.blobs;
+        stats_.nodes += scan.nodes;
+        stats_.ways += scan.ways;
+        stats_.relations += scan.relations;
+        if (scan.nodes != 0) {
+            extent_.add(scan.south, scan.west);
+            extent_.add(scan.north, scan.east);
+        }
+        if (scan.kinds != 0) blobs_.push_back({scan.offset, scan.kinds, scan.minNodeId, scan.maxNodeId});
+
+        for (const auto& node : scan.poiNodes) {
+            intern(node.tags);
+            auto added = writer.add(poistore::kNode, static_cast<std::uint64_t>(node.id), node.lat, node.lon, tags);
+            if (!added) return added;
+            ++stats_.poiNodes;
+        }
+        for (const auto& way : scan.poiWays) {
+            intern(way.tags);
+            auto geometry = addGeometry_(way.refs);
+            if (!geometry) return std::unexpected(geometry.error());
+            Pending pending{poistore::kWay, way.id, *geometry, static_cast<std::uint32_t>(tags.size()), 0};
+            if (auto added = addPending_(pending, tags, {}); !added) return added;
+        }
+        for (const auto& relation : scan.poiRelations) {
+            intern(relation.tags);
+
+            // Node members form one geometry; way members are looked up
+            // once all ways are known. Nested relations are not followed.
+            std::vector<std::int64_t> nodes;
+            std::vector<std::int64_t> ways;
+            for (const auto& [type, ref] : relation.members) {
+                if (type == pbf::MemberType::Node) nodes.push_back(ref);
+                else if (type == pbf::MemberType::Way) ways.push_back(ref);
+            }
+            memberWays_.insert(memberWays_.end(), ways.begin(), ways.end());
+            auto geometry = addGeometry_(nodes);
+            if (!geometry) return std::unexpected(geometry.error());
+            Pending pending{poistore::kRelation, relation.id, *geometry, static_cast<std::uint32_t>(tags.size()),
+                            static_cast<std::uint32_t>(ways.size())};
+            if (auto added = addPending_(pending, tags, ways); !added) return added;
+        }
+        return {};
+    };
+
+    if (auto status = runPass_<BlobScan>(file, nullptr, decode, consume); !status) return status;
+    if (pendingOut_.is_open()) {
+        pendingOut_.close();
+        if (!pendingOut_) {
+            return std::unexpected(std::format("Cannot write {}: {}", pendingPath_, std::strerror(errno)));
+        }
+    }
+    return {};
+}
+
+std::expected<void, std::string> PoiStoreBuilder::collectMemberWays_(pbf::PbfFile& file) {
+    if (memberWays_.empty()) return {};
+    std::ranges::sort(memberWays_);
+    memberWays_.erase(std::unique(memberWays_.begin(), memberWays_.end()), memberWays_.end());
+
+    // Only the POI ways that are members of a relation keep their geometry at hand
+    auto indexed = forEachPending_([this](const Pending& pending, std::span<const std::uint32_t>,
+                                          std::span<const std::int64_t>) -> std::expected<void, std::string> {
+        if (pending.type == poistore::kWay && std::ranges::binary_search(memberWays_, pending.id)) {
+            wayGeometry_.emplace(pending.id, pending.geometry);
+        }
+        return {};
+    });
+    if (!indexed) return indexed;
+
+    std::vector<std::int64_t> missing;
+    for (auto id : memberWays_) {
+        if (!wayGeometry_.contains(id)) missing.push_back(id);
+    }
+    if (missing.empty()) return {};
+
+    auto decode = [&missing](const pbf::RawBlob& blob) -> std::expected<WayRefs, std::string> {
+        auto data = pbf::blobData(blob.blob);
+        if (!data) return std::unexpected(data.error());
+
+        WayRefs found;
+        pbf::BlockHandler handler;
+        handler.way = [&](const pbf::Way& way) {
+            if (std::ranges::binary_search(missing, way.id)) found.emplace_back(way.id, way.refs);
+        };
+        if (auto status = pbf::decodeBlock(*data, handler); !status) return std::unexpected(status.error());
+        return found;
+    };
+    auto consume = [this](WayRefs found) -> std::expected<void, std::string> {
+        for (const auto& [id, refs] : found) {
+            auto geometry = addGeometry_(refs);
+            if (!geometry) return std::unexpected(geometry.error());
+            wayGeometry_.emplace(id, *geometry);
+        }
+        return {};
+    };
+
+    auto offsets = blobsWith_(kHasWays);
+    return runPass_<WayRefs>(file, &offsets, decode, consume);
+}
+
+std::expected<void, std::string> PoiStoreBuilder::resolveNodes_(pbf::PbfFile& file) {
+    // Each chunk holds the ids and positions of as many nodes as fit the
+    // budget; gathering the ids takes twice their room
+    constexpr std::size_t kBytesPerNode = 2 * sizeof(std::int64_t) + 2 * sizeof(double);
+    std::size_t chunkSize = std::max<std::size_t>(options_.memoryBudget / 4 / kBytesPerNode, 1);
+
+    std::optional<std::int64_t> last;
+    while (true) {
+        auto needed = nextChunk_(last, chunkSize);
+        if (!needed) return std::unexpected(needed.error());
+        if (needed->empty()) return {};
+        last = needed->back();
+
+        std::span<const std::int64_t> chunk(*needed);
+        std::vector<double> lats(chunk.size(), std::nan(""));
+        std::vector<double> lons(chunk.size(), std::nan(""));
+
+        auto decode = [chunk](const pbf::RawBlob& blob) -> std::expected<NodePositions, std::string> {
+            auto data = pbf::blobData(blob.blob);
+            if (!data) return std::unexpected(data.error());
+
+            NodePositions found;
+            pbf::BlockHandler handler;
+            handler.node = [&](const pbf::Node& node) {
+                if (std::ranges::binary_search(chunk, node.id)) found.emplace_back(node.id, node.lat, node.lon);
+            };
+            if (auto status = pbf::decodeBlock(*data, handler); !status) return std::unexpected(status.error());
+            return found;
+        };
+        auto consume = [&](NodePositions found) -> std::expected<void, std::string> {
+            for (const auto& [id, lat, lon] : found) {
+                auto i = static_cast<std::size_t>(std::ranges::lower_bound(chunk, id) - chunk.begin());
+                lats[i] = lat;
+                lons[i] = lon;
+            }
+            return {};
+        };
+
+        auto offsets = blobsWithNodes_(chunk);
+        if (auto status = runPass_<NodePositions>(file, &offsets, decode, consume); !status) return status;
+
+        std::size_t g = 0;
+        auto widened = forEachRef_([&](std::uint64_t r, std::int64_t ref) {
+            while (geometries_[g].refEnd <= r) ++g;
+            if (ref < chunk.front() || ref > chunk.back()) return;
+            auto i = static_cast<std::size_t>(std::ranges::lower_bound(chunk, ref) - chunk.begin());
+            if (!std::isnan(lats[i])) geometries_[g].add(lats[i], lons[i]);
+        });
+        if (!widened) return widened;
+        if (chunk.size() < chunkSize) return {};
+    }
+}
+
+std::expected<void, std::string> PoiStoreBuilder::writePending_(PoiStoreWriter& writer) {
+    return forEachPending_([&](const Pending& pending, std::span<const std::uint32_t> tags,
+                               std::span<const std::int64_t> members) -> std::expected<void, std::string> {
+        Geometry box = geometries_[pending.geometry];
+        for (auto member : members) {
+            if (auto way = wayGeometry_.find(member); way != wayGeometry_.end()) box.add(geometries_[way->second]);
+        }
+        if (!box.resolved()) {
+            ++stats_.unresolved;
+            return {};
+        }
+
+        auto added = writer.add(pending.type, static_cast<std::uint64_t>(pending.id), (box.south + box.north) / 2,
+                                (box.west + box.east) / 2, tags);
+        if (!added) return added;
+        if (pending.type == poistore::kWay) ++stats_.poiWays;
+        else ++stats_.poiRelations;
+        return {};
+    });
+}
+
+std::expected<std::uint32_t, std::string> PoiStoreBuilder::addGeometry_(const std::vector<std::int64_t>& refs) {
+    Geometry geometry;
+    geometry.refBegin = spilledRefs_ + refs_.size();
+    refs_.insert(refs_.end(), refs.begin(), refs.end());
+    geometry.refEnd = spilledRefs_ + refs_.size();
+    geometries_.push_back(geometry);
+
+    if (refs_.size() * sizeof(std::int64_t) >= refBufferBytes_) {
+        if (auto spilled = spillRefs_(); !spilled) return std::unexpected(spilled.error());
+    }
+    return static_cast<std::uint32_t>(geometries_.size() - 1);
+}
+
+std::expected<void, std::string> PoiStoreBuilder::addPending_(const Pending& pending,
+                                                              std::span<const std::uint32_t> tags,
+                                                              std::span<const std::int64_t> members) {
+    if (!pendingOut_.is_open()) {
+        pendingOut_.open(pendingPath_, std::ios::binary | std::ios::trunc);
+        if (!pendingOut_) {
+            return std::unexpected(std::format("Cannot create {}: {}", pendingPath_, std::strerror(errno)));
+        }
+    }
+
+    pendingOut_.write(reinterpret_cast<const char*>(&pending), sizeof(pending));
+    pendingOut_.write(reinterpret_cast<const char*>(tags.data()),
+                      static_cast<std::streamsize>(tags.size() * sizeof(std::uint32_t)));
+    pendingOut_.write(reinterpret_cast<const char*>(members.data()),
+                      static_cast<std::streamsize>(members.size() * sizeof(std::int64_t)));
+    if (!pendingOut_) return std::unexpected(std::format("Cannot write {}: {}", pendingPath_, std::strerror(errno)));
+    ++pendingCount_;
+    return {};
+}
+
+// Calls visit(pending, tags, member ways) for every spilled way and
+// relation, in scan order, until a call fails
+template <typename Visit>
+std::expected<void, std::string> PoiStoreBuilder::forEachPending_(Visit visit) const {
+    if (pendingCount_ == 0) return {};
+    std::ifstream in(pendingPath_, std::ios::binary);
+    Pending pending{};
+    std::vector<std::uint32_t> tags;
+    std::vector<std::int64_t> members;
+    for (std::uint64_t i = 0; i < pendingCount_; ++i) {
+        in.read(reinterpret_cast<char*>(&pending), sizeof(pending));
+        tags.resize(pending.tagCount);
+        members.resize(pending.memberCount);
+        in.read(reinterpret_cast<char*>(tags.data()),
+                static_cast<std::streamsize>(tags.size() * sizeof(std::uint32_t)));
+        in.read(reinterpret_cast<char*>(members.data()),
+                static_cast<std::streamsize>(members.size() * sizeof(std::int64_t)));
+        if (!in) return std::unexpected(std::format("Cannot read {}: {}", pendingPath_, std::strerror(errno)));
+        if (auto status = visit(pending, std::span<const std::uint32_t>(tags), std::span<const std::int64_t>(members));
+            !status) {
+            return status;
+        }
+    }
+    return {};
+}
+
+std::expected<void, std::string> PoiStoreBuilder::spillRefs_() {
+    std::ofstream out(refsPath_, std::ios::binary | (spilledRefs_ == 0 ? std::ios::trunc : std::ios::app));
+    if (!out) return std::unexpected(std::format("Cannot create {}: {}", refsPath_, std::strerror(errno)));
+
+    out.write(reinterpret_cast<const char*>(refs_.data()),
+              static_cast<std::streamsize>(refs_.size() * sizeof(std::int64_t)));
+    if (!out.flush()) return std::unexpected(std::format("Cannot write {}: {}", refsPath_, std::strerror(errno)));
+
+    spilledRefs_ += refs_.size();
+    refs_.clear();
+    return {};
+}
+
+// Calls visit(index, id) for every node id of the geometries, in order
+template <typename Visit>
+std::expected<void, std::string> PoiStoreBuilder::forEachRef_(Visit visit) const {
+    std::uint64_t index = 0;
+    if (spilledRefs_ != 0) {
+        std::ifstream in(refsPath_, std::ios::binary);
+        std::vector<std::int64_t> block(kRefBlock);
+        while (index < spilledRefs_) {
+            auto count = static_cast<std::size_t>(std::min<std::uint64_t>(block.size(), spilledRefs_ - index));
+            if (!in.read(reinterpret_cast<char*>(block.data()),
+                         static_cast<std::streamsize>(count * sizeof(std::int64_t)))) {
+                return std::unexpected(std::format("Cannot read {}: {}", refsPath_, std::strerror(errno)));
+            }
+            for (std::size_t i = 0; i < count; ++i) visit(index++, block[i]);
+        }
+    }
+    for (auto ref : refs_) visit(index++, ref);
+    return {};
+}
+
+// The chunkSize smallest distinct node ids above @p after, ascending. Ids are
+// gathered into twice that room, which is sorted and cut back when full.
+std::expected<std::vector<std::int64_t>, std::string> PoiStoreBuilder::nextChunk_(std::optional<std::int64_t> after,
+                                                                                 std::size_t chunkSize) const {
+    std::vector<std::int64_t> chunk;
+    chunk.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(2 * chunkSize, spilledRefs_ + refs_.size())));
+    std::optional<std::int64_t> bound; // the chunk is full up to here
+    auto cut = [&] {
+        std::ranges::sort(chunk);
+        chunk.erase(std::unique(chunk.begin(), chunk.end()), chunk.end());
+        if (chunk.size() >= chunkSize) {
+            chunk.resize(chunkSize);
+            bound = chunk.back();
+        }
+    };
+
+    auto gathered = forEachRef_([&](std::uint64_t, std::int64_t ref) {
+        if ((after && ref <= *after) || (bound && ref > *bound)) return;
+        if (chunk.size() == 2 * chunkSize) cut();
+        chunk.push_back(ref);
+    });
+    if (!gathered) return std::unexpected(gathered.error());
+    cut();
+    return chunk;
+}
+
+std::vector<std::uint64_t> PoiStoreBuilder::blobsWith_(std::uint8_t kinds) const {
+    std::vector<std::uint64_t> offsets;
+    for (const auto& blob : blobs_) {
+        if (blob.kinds & kinds) offsets.push_back(blob.offset);
+    }
+    return offsets;
+}
+
+std::vector<std::uint64_t> PoiStoreBuilder::blobsWithNodes_(std::span<const std::int64_t> ids) const {
+    // Extracts are sorted by id, so a blob's id range rarely holds ids of other blobs
+    std::vector<std::uint64_t> offsets;
+    for (const auto& blob : blobs_) {
+        if (!(blob.kinds & kHasNodes)) continue;
+        auto id = std::ranges::lower_bound(ids, blob.minNodeId);
+        if (id != ids.end() && *id <= blob.maxNodeId) offsets.push_back(blob.offset);
+    }
+    return offsets;
+}
+
+bool PoiStoreBuilder::relevant_(const pbf::Tags& tags) const {
+    if (keys_.empty()) return !tags.empty();
+    return std::ranges::any_of(tags, [this](const auto& tag) { return keys_.contains(tag.first); });
+}
@@ -0,0 +1,165 @@
+/**
+ * SPDX-FileComment: Internal header for the POI store import
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file PoiStoreBuilder.hpp
+ * @brief Defines PoiStoreBuilder, which imports a `.osm.pbf` extract into a
+ * POI store in parallel, multi-pass and with bounded memory.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "BlobPipeline.hpp"
+#include "Pbf.hpp"
+#include "PoiOsm.hpp"
+#include "PoiStoreWriter.hpp"
+
+/**
+ * @brief Imports an extract into a POI store.
+ *
+ * Every pass reads blobs on the calling thread and decodes them on a
+ * BlobPipeline:
+ * 1. Scan: all blobs. Nodes with a POI tag go straight to the writer; POI
+ *    ways keep their node ids, POI relations their members. Each blob's
+ *    element kinds and node id range are remembered. Node ids beyond a
+ *    quarter of the memory budget are spilled to `<store>.refs`.
+ * 2. Member ways (only if relations need ways that are no POIs): the way
+ *    blobs again, for the node ids of those ways.
+ * 3. Node positions: the node blobs whose id range holds needed nodes. The
+ *    needed ids are resolved in chunks that fit the memory budget, one
+ *    pass per chunk, widening the bounding box of each way and relation.
+ *    Each chunk is gathered by streaming the node ids, so they are never
+ *    held twice.
+ * Ways and relations are then written at the center of their bounding box.
+ * Their records and tags are appended to `<store>.pending` during the scan
+ * and streamed back to write them. Only their bounding boxes, and the ids
+ * and bounding boxes of the ways that relations have as members, stay in
+ * memory, outside the budget.
+ */
+class PoiStoreBuilder {
+public:
+    explicit PoiStoreBuilder(PoiImportOptions options);
+
+    /// Removes the spilled node ids and records.
+    ~PoiStoreBuilder();
+
+    PoiStoreBuilder(const PoiStoreBuilder&) = delete;
+    PoiStoreBuilder& operator=(const PoiStoreBuilder&) = delete;
+
+    /**
+     * @brief Runs the import.
+     *
+     * @param pbfPath Path of the `.osm.pbf` extract.
+     * @param storePath Path of the store to write.
+     * @return std::expected<PoiImportStats, std::string> Counts and timing, or an error message.
+     */
+    std::expected<PoiImportStats, std::string> build(const std::string& pbfPath, const std::string& storePath);
+
+private:
+    // Element kinds of a blob
+    static constexpr std::uint8_t kHasNodes = 1;
+    static constexpr std::uint8_t kHasWays = 2;
+
+    struct BlobInfo {
+        std::uint64_t offset;
+        std::uint8_t kinds;
+        std::int64_t minNodeId;
+        std::int64_t maxNodeId;
+    };
+
+    // Node ids of a way (or of a relation's node members) and their bounding box;
+    // geometries own consecutive ranges of the node ids, in order
+    struct Geometry {
+        std::uint64_t refBegin;
+        std::uint64_t refEnd;
+        double south = 90.0;
+        double west = 180.0;
+        double north = -90.0;
+        double east = -180.0;
+
+        bool resolved() const { return south <= north; }
+        void add(double lat, double lon);
+        void add(const Geometry& other);
+    };
+
+    // A way or relation waiting for its node positions; in pendingPath_ it is
+    // followed by its tags and the ids of its member ways
+    struct Pending {
+        poistore::ElementType type;
+        std::int64_t id;
+        std::uint32_t geometry;
+        std::uint32_t tagCount;
+        std::uint32_t memberCount;
+    };
+
+    template <typename Result>
+    std::expected<void, std::string> runPass_(pbf::PbfFile& file, const std::vector<std::uint64_t>* offsets,
+                                              typename BlobPipeline<Result>::Decode decode,
+                                              typename BlobPipeline<Result>::Consume consume);
+
+    std::expected<void, std::string> scan_(pbf::PbfFile& file, PoiStoreWriter& writer);
+    std::expected<void, std::string> collectMemberWays_(pbf::PbfFile& file);
+    std::expected<void, std::string> resolveNodes_(pbf::PbfFile& file);
+    std::expected<void, std::string> writePending_(PoiStoreWriter& writer);
+
+    std::expected<std::uint32_t, std::string> addGeometry_(const std::vector<std::int64_t>& refs);
+    std::expected<void, std::string> addPending_(const Pending& pending, std::span<const std::uint32_t> tags,
+                                                 std::span<const std::int64_t> members);
+    template <typename Visit>
+    std::expected<void, std::string> forEachPending_(Visit visit) const;
+    std::expected<void, std::string> spillRefs_();
+    template <typename Visit>
+    std::expected<void, std::string> forEachRef_(Visit visit) const;
+    std::expected<std::vector<std::int64_t>, std::string> nextChunk_(std::optional<std::int64_t> after,
+                                                                     std::size_t chunkSize) const;
+    std::vector<std::uint64_t> blobsWith_(std::uint8_t kinds) const;
+    std::vector<std::uint64_t> blobsWithNodes_(std::span<const std::int64_t> ids) const;
+    bool relevant_(const pbf::Tags& tags) const;
+
+    PoiImportOptions options_;
+    unsigned threads_;
+    std::unordered_set<std::string_view> keys_; // views into options_.keys
+    PoiImportStats stats_;
+
+    bool sawHeader_ = false;
+    std::optional<pbf::Bounds> bounds_;
+    Geometry extent_{};
+    std::vector<BlobInfo> blobs_;
+
+    // Node ids of all geometries: the first spilledRefs_ in refsPath_, the rest in refs_
+    std::string refsPath_;
+    std::size_t refBufferBytes_ = 0;
+    std::uint64_t spilledRefs_ = 0;
+    std::vector<std::int64_t> refs_;
+    std::vector<Geometry> geometries_;
+
+    // Ways and relations in pendingPath_, in the order they were scanned
+    std::string pendingPath_;
+    std::ofstream pendingOut_;
+    std::uint64_t pendingCount_ = 0;
+
+    // Member ways of relations, sorted and distinct after the scan, and the
+    // geometries of those found
+    std::vector<std::int64_t> memberWays_;
+    std::unordered_map<std::int64_t, std::uint32_t> wayGeometry_;
+};
@@ -0,0 +1,92 @@
+/**
+ * SPDX-FileComment: Internal header for the POI store file format
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file PoiStoreFormat.hpp
+ * @brief Defines the on-disk layout shared by the POI store reader and writer.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "GridIndex.hpp"
+
+namespace poistore {
+
+inline constexpr char kMagic[8] = {'G', 'P', 'O', 'I', 'P', 'O', 'I', 'S'};
+inline constexpr std::uint32_t kFormatVersion = 4;
+
+/// Header::flags bit: the store holds ways and relations, placed at their center.
+inline constexpr std::uint32_t kFlagWaysAndRelations = 1;
+
+/// Element type values of the types section.
+enum ElementType : std::uint8_t { kNode = 0, kWay = 1, kRelation = 2 };
+
+/// Coordinates are stored as int32 multiples of this, OSM's own precision.
+inline constexpr double kCoordinateUnit = geo::kCoordinateUnit;
+
+/// Grid cells per degree of latitude and longitude; cells are about 1.7 km high.
+inline constexpr std::uint32_t kCellsPerDegree = 64;
+
+/// Largest cells-per-degree value whose cell keys fit 32 bits.
+inline constexpr std::uint32_t kMaxCellsPerDegree = grid::kMaxCellsPerDegree;
+
+/// Sections of the file, in file order.
+enum Section : std::uint32_t {
+    kIds,           ///< std::uint64_t OSM id per POI.
+    kLatitudes,     ///< std::int32_t latitude per POI, in kCoordinateUnit.
+    kLongitudes,    ///< std::int32_t longitude per POI, in kCoordinateUnit.
+    kTagRanges,     ///< recordCount + 1 std::uint32_t: the tags of POI i are [range[i], range[i + 1]).
+    kTypes,         ///< ElementType per POI.
+    kTags,          ///< (key, value) pairs of std::uint32_t string indices.
+    kKeys,          ///< std::uint32_t string indices of the tag keys the import kept (none: all).
+    kCells,         ///< Cell entries of the non-empty grid cells, by Hilbert key.
+    kStringOffsets, ///< stringCount + 1 std::uint32_t offsets into the string bytes.
+    kStrings,       ///< String bytes.
+    kSectionCount
+};
+
+/**
+ * @brief Start of the file.
+ *
+ * Every section starts at an offset aligned to 8 bytes; all values are in
+ * native byte order. The POIs are stored as columns (structure of arrays),
+ * sorted by the Hilbert key of their grid cell (grid::cellKey()), so the
+ * POIs of a cell are contiguous, nearby cells are mostly close in the file
+ * and the cell section is the directory of a GridIndex.
+ */
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+    double south;
+    double west;
+    double north;
+    double east;
+    std::uint64_t recordCount;
+    std::uint64_t tagCount;
+    std::uint64_t keyCount;
+    std::uint64_t cellCount;
+    std::uint64_t stringCount;
+    std::uint64_t stringBytes;
+    std::uint32_t cellsPerDegree;
+    std::uint32_t reserved;
+    std::uint64_t sections[kSectionCount]; ///< Offset of each section.
+};
+
+/// One non-empty grid cell; its POIs run up to the next cell's first (or the end).
+using Cell = grid::Cell;
+
+static_assert(sizeof(Header) == 184);
+static_assert(sizeof(Cell) == 8);
+
+} // namespace poistore
@@ -0,0 +1,286 @@
+/**
+ * SPDX-FileComment: Implementation of the POI store writer
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file PoiStoreWriter.cpp
+ * @brief Implements PoiStoreWriter: buffering, sorted runs and the final merge.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "PoiStoreWriter.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <queue>
+#include <tuple>
+
+namespace {
+
+constexpr const char* kSectionNames[poistore::kSectionCount] = {
+    "ids", "lat", "lon", "tagranges", "types", "tags", "keys", "cells", "stringoffsets", "strings"};
+
+std::string errnoText() {
+    return std::strerror(errno);
+}
+
+template <typename T>
+void writeArray(std::ostream& out, const T* values, std::size_t count) {
+    out.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+} // namespace
+
+// Sequential reader of one spilled run
+class PoiStoreWriter::RunReader {
+public:
+    RunReader(const std::string& path, std::uint64_t offset, std::uint64_t count)
+        : in_(path, std::ios::binary), remaining_(count) {
+        in_.seekg(static_cast<std::streamoff>(offset));
+    }
+
+    // Reads the next record and its tags; false at the end of the run or on error
+    bool next() {
+        if (remaining_ == 0) return false;
+        --remaining_;
+        if (!in_.read(reinterpret_cast<char*>(&record_), sizeof(record_))) return false;
+        tags_.resize(std::size_t{record_.tagCount} * 2);
+        return static_cast<bool>(
+            in_.read(reinterpret_cast<char*>(tags_.data()), static_cast<std::streamsize>(tags_.size() * 4)));
+    }
+
+    bool ok() const { return !in_.fail(); }
+    const Record& record() const { return record_; }
+    const std::vector<std::uint32_t>& tags() const { return tags_; }
+
+private:
+    std::ifstream in_;
+    std::uint64_t remaining_;
+    Record record_{};
+    std::vector<std::uint32_t> tags_;
+};
+
+namespace {
+
+// POIs are ordered by the Hilbert key of their grid cell, so each cell's POIs are
+// contiguous and nearby cells mostly adjacent; latitude, type and id make the
+// order total, so the same extract always gives the same file
+auto sortKey(const auto& r) {
+    return std::tuple(r.cell, r.lat, r.type, r.id);
+}
+
+} // namespace
+
+PoiStoreWriter::PoiStoreWriter(std::string path, std::size_t bufferBytes)
+    : path_(std::move(path)), bufferBytes_(bufferBytes) {}
+
+PoiStoreWriter::~PoiStoreWriter() {
+    std::remove((path_ + ".runs").c_str());
+    std::remove((path_ + ".tmp").c_str());
+    for (std::uint32_t section = 0; section < poistore::kSectionCount; ++section) {
+        std::remove(sectionPath_(static_cast<poistore::Section>(section)).c_str());
+    }
+}
+
+std::uint32_t PoiStoreWriter::intern(std::string_view s) {
+    if (auto it = stringIndex_.find(s); it != stringIndex_.end()) return it->second;
+
+    auto id = static_cast<std::uint32_t>(stringOffsets_.size() - 1);
+    strings_.append(s);
+    stringOffsets_.push_back(static_cast<std::uint32_t>(strings_.size()));
+    stringIndex_.emplace(std::string(s), id);
+    return id;
+}
+
+std::expected<void, std::string> PoiStoreWriter::add(poistore::ElementType type, std::uint64_t id, double lat,
+                                                     double lon, std::span<const std::uint32_t> tags) {
+    Record record{};
+    record.id = id;
+    record.lat = geo::quantize(lat);
+    record.lon = geo::quantize(lon);
+    record.cell = grid::cellKey(record.lat, record.lon, poistore::kCellsPerDegree);
+    record.firstTag = static_cast<std::uint32_t>(tags_.size() / 2);
+    record.tagCount = static_cast<std::uint32_t>(tags.size() / 2);
+    record.type = type;
+    records_.push_back(record);
+    tags_.insert(tags_.end(), tags.begin(), tags.end());
+
+    if (records_.size() * sizeof(Record) + tags_.size() * sizeof(std::uint32_t) < bufferBytes_) return {};
+    return spill_();
+}
+
+std::vector<std::size_t> PoiStoreWriter::sortedBuffer_() const {
+    std::vector<std::size_t> order(records_.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::ranges::sort(order, {}, [this](std::size_t i) { return sortKey(records_[i]); });
+    return order;
+}
+
+std::string PoiStoreWriter::sectionPath_(poistore::Section section) const {
+    return std::format("{}.{}", path_, kSectionNames[section]);
+}
+
+std::expected<void, std::string> PoiStoreWriter::spill_() {
+    std::string runPath = path_ + ".runs";
+    std::ofstream out(runPath, std::ios::binary | (runs_.empty() ? std::ios::trunc : std::ios::app));
+    if (!out) return std::unexpected(std::format("Cannot create {}: {}", runPath, errnoText()));
+
+    Run run{runBytes_, records_.size()};
+    for (auto i : sortedBuffer_()) {
+        const auto& record = records_[i];
+        writeArray(out, &record, 1);
+        writeArray(out, tags_.data() + std::size_t{record.firstTag} * 2, std::size_t{record.tagCount} * 2);
+        runBytes_ += sizeof(Record) + std::size_t{record.tagCount} * 2 * sizeof(std::uint32_t);
+    }
+    if (!out.flush()) return std::unexpected(std::format("Cannot write {}: {}", runPath, errnoText()));
+
+    runs_.push_back(run);
+    records_.clear();
+    tags_.clear();
+    return {};
+}
+
+std::expected<std::uint64_t, std::string> PoiStoreWriter::finish(poistore::Header header,
+                                                                 const std::vector<std::uint32_t>& keys) {
+    using poistore::Section;
+
+    if (!runs_.empty() && !records_.empty()) {
+        if (auto spilled = spill_(); !spilled) return std::unexpected(spilled.error());
+    }
+
+    // The merged POIs are streamed column by column into side files, which
+    // are then copied into the store
+    constexpr Section kColumns[] = {poistore::kIds,   poistore::kLatitudes, poistore::kLongitudes, poistore::kTagRanges,
+                                    poistore::kTypes, poistore::kTags,      poistore::kCells};
+    std::ofstream columns[poistore::kSectionCount];
+    for (auto section : kColumns) {
+        columns[section].open(sectionPath_(section), std::ios::binary | std::ios::trunc);
+        if (!columns[section]) {
+            return std::unexpected(std::format("Cannot create {}: {}", sectionPath_(section), errnoText()));
+        }
+    }
+
+    std::uint64_t recordCount = 0;
+    std::uint64_t tagCount = 0;
+    std::uint64_t cellCount = 0;
+    std::optional<std::uint32_t> lastCell;
+    auto emit = [&](const Record& record, const std::uint32_t* tags) {
+        if (record.cell != lastCell) {
+            poistore::Cell cell{record.cell, static_cast<std::uint32_t>(recordCount)};
+            writeArray(columns[poistore::kCells], &cell, 1);
+            lastCell = record.cell;
+            ++cellCount;
+        }
+        auto firstTag = static_cast<std::uint32_t>(tagCount);
+        writeArray(columns[poistore::kIds], &record.id, 1);
+        writeArray(columns[poistore::kLatitudes], &record.lat, 1);
+        writeArray(columns[poistore::kLongitudes], &record.lon, 1);
+        writeArray(columns[poistore::kTagRanges], &firstTag, 1);
+        writeArray(columns[poistore::kTypes], &record.type, 1);
+        writeArray(columns[poistore::kTags], tags, std::size_t{record.tagCount} * 2);
+        ++recordCount;
+        tagCount += record.tagCount;
+    };
+
+    if (runs_.empty()) {
+        for (auto i : sortedBuffer_()) emit(records_[i], tags_.data() + std::size_t{records_[i].firstTag} * 2);
+    } else {
+        std::vector<std::unique_ptr<RunReader>> readers;
+        for (const auto& run : runs_) {
+            readers.push_back(std::make_unique<RunReader>(path_ + ".runs", run.offset, run.count));
+        }
+
+        auto later = [&](std::size_t a, std::size_t b) {
+            return sortKey(readers[b]->record()) < sortKey(readers[a]->record());
+        };
+        std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(later)> heads(later);
+        for (std::size_t i = 0; i < readers.size(); ++i) {
+            if (readers[i]->next()) heads.push(i);
+        }
+        while (!heads.empty()) {
+            auto i = heads.top();
+            heads.pop();
+            emit(readers[i]->record(), readers[i]->tags().data());
+            if (readers[i]->next()) heads.push(i);
+        }
+        for (const auto& reader : readers) {
+            if (!reader->ok()) return std::unexpected(std::format("Cannot read {}.runs", path_));
+        }
+    }
+    constexpr std::uint64_t kMaxIndex = std::numeric_limits<std::uint32_t>::max();
+    if (recordCount >= kMaxIndex || tagCount > kMaxIndex || strings_.size() > kMaxIndex) {
+        return std::unexpected(std::format("Cannot build POI store {}: extract too large", path_));
+    }
+    auto endTag = static_cast<std::uint32_t>(tagCount);
+    writeArray(columns[poistore::kTagRanges], &endTag, 1);
+    for (auto section : kColumns) {
+        columns[section].close();
+        if (!columns[section]) {
+            return std::unexpected(std::format("Cannot write {}: {}", sectionPath_(section), errnoText()));
+        }
+    }
+
+    std::string tmpPath = path_ + ".tmp";
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out) return std::unexpected(std::format("Cannot create POI store {}: {}", tmpPath, errnoText()));
+
+    // Sections start 8-byte aligned, so a mapped store can be read in place
+    std::uint64_t offset = sizeof(poistore::Header);
+    out.seekp(static_cast<std::streamoff>(offset));
+    auto align = [&] {
+        constexpr char kPadding[8] = {};
+        std::uint64_t padding = (8 - offset % 8) % 8;
+        out.write(kPadding, static_cast<std::streamsize>(padding));
+        offset += padding;
+    };
+    for (std::uint32_t i = 0; i < poistore::kSectionCount; ++i) {
+        auto section = static_cast<Section>(i);
+        align();
+        header.sections[section] = offset;
+        if (section == poistore::kKeys) {
+            writeArray(out, keys.data(), keys.size());
+        } else if (section == poistore::kStringOffsets) {
+            writeArray(out, stringOffsets_.data(), stringOffsets_.size());
+        } else if (section == poistore::kStrings) {
+            out.write(strings_.data(), static_cast<std::streamsize>(strings_.size()));
+        } else {
+            std::ifstream in(sectionPath_(section), std::ios::binary);
+            if (in.peek() != std::ifstream::traits_type::eof()) out << in.rdbuf();
+        }
+        offset = static_cast<std::uint64_t>(out.tellp());
+    }
+
+    std::memcpy(header.magic, poistore::kMagic, sizeof(poistore::kMagic));
+    header.version = poistore::kFormatVersion;
+    header.recordCount = recordCount;
+    header.tagCount = tagCount;
+    header.keyCount = keys.size();
+    header.cellCount = cellCount;
+    header.stringCount = stringOffsets_.size() - 1;
+    header.stringBytes = strings_.size();
+    header.cellsPerDegree = poistore::kCellsPerDegree;
+    out.seekp(0);
+    writeArray(out, &header, 1);
+    out.close();
+    if (!out) return std::unexpected(std::format("Cannot write POI store {}: {}", tmpPath, errnoText()));
+
+    // Readers never see a partial store
+    if (std::rename(tmpPath.c_str(), path_.c_str()) != 0) {
+        return std::unexpected(std::format("Cannot replace POI store {}: {}", path_, errnoText()));
+    }
+    return recordCount;
+}
@@ -0,0 +1,126 @@
+/**
+ * SPDX-FileComment: Internal header for the POI store writer
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file PoiStoreWriter.hpp
+ * @brief Defines PoiStoreWriter, which writes POI store files with a bounded
+ * record buffer by spilling sorted runs to disk.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "PoiStoreFormat.hpp"
+
+/**
+ * @brief Collects POIs and writes them as a POI store.
+ *
+ * Tag strings are interned into one dictionary as they arrive. Records and
+ * their tag indices are buffered up to a memory budget; a full buffer is
+ * sorted by grid cell (in Hilbert curve order) and spilled as a run to
+ * `<path>.runs`. finish() merges the runs (or sorts the buffer if nothing
+ * was spilled) and streams each column to a side file `<path>.<section>`;
+ * the columns are then copied into `<path>.tmp`, which is renamed into
+ * place. Only the string dictionary grows without bound, with the number
+ * of distinct tag keys and values.
+ */
+class PoiStoreWriter {
+public:
+    /**
+     * @brief Creates a writer.
+     *
+     * @param path Path of the store to write.
+     * @param bufferBytes Records and tags buffered before a run is spilled.
+     */
+    PoiStoreWriter(std::string path, std::size_t bufferBytes);
+
+    /// Removes the temporary files that are left.
+    ~PoiStoreWriter();
+
+    PoiStoreWriter(const PoiStoreWriter&) = delete;
+    PoiStoreWriter& operator=(const PoiStoreWriter&) = delete;
+
+    /// Returns the dictionary index of @p s, adding it if new.
+    std::uint32_t intern(std::string_view s);
+
+    /**
+     * @brief Adds a POI.
+     *
+     * @param type Element type.
+     * @param id OSM id.
+     * @param lat Latitude (of the center for ways and relations).
+     * @param lon Longitude.
+     * @param tags (key, value) pairs of dictionary indices, flattened.
+     * @return std::expected<void, std::string> Empty on success, or an error message.
+     */
+    std::expected<void, std::string> add(poistore::ElementType type, std::uint64_t id, double lat, double lon,
+                                         std::span<const std::uint32_t> tags);
+
+    /**
+     * @brief Writes the store.
+     *
+     * @param header Bounds and flags of the store; the counts are filled in.
+     * @param keys Dictionary indices of the tag keys the import kept.
+     * @return std::expected<std::uint64_t, std::string> The number of POIs written or an error message.
+     */
+    std::expected<std::uint64_t, std::string> finish(poistore::Header header, const std::vector<std::uint32_t>& keys);
+
+    /// Runs spilled to disk so far.
+    std::size_t runs() const { return runs_.size(); }
+
+private:
+    // A buffered POI; firstTag points into tags_
+    struct Record {
+        std::uint64_t id;
+        std::int32_t lat;
+        std::int32_t lon;
+        std::uint32_t cell;
+        std::uint32_t firstTag;
+        std::uint32_t tagCount;
+        std::uint8_t type;
+    };
+
+    class RunReader;
+
+    struct Run {
+        std::uint64_t offset;
+        std::uint64_t count;
+    };
+
+    struct Hash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    std::expected<void, std::string> spill_();
+    std::vector<std::size_t> sortedBuffer_() const;
+    std::string sectionPath_(poistore::Section section) const;
+
+    std::string path_;
+    std::size_t bufferBytes_;
+
+    std::unordered_map<std::string, std::uint32_t, Hash, std::equal_to<>> stringIndex_;
+    std::vector<std::uint32_t> stringOffsets_{0};
+    std::string strings_;
+
+    std::vector<Record> records_;
+    std::vector<std::uint32_t> tags_;
+    std::vector<Run> runs_;
+    std::uint64_t runBytes_ = 0;
+};
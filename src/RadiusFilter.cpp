@@ -0,0 +1,344 @@
+/**
+ * SPDX-FileComment: Implementation of the vectorized radius filter
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file RadiusFilter.cpp
+ * @brief Implements the kernels of RadiusFilter and their selection at runtime.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "RadiusFilter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <type_traits>
+
+#include "Geo.hpp"
+
+// GCC and Clang vector extensions give one kernel source for every width;
+// other compilers get the scalar kernel only
+#if defined(__GNUC__)
+#define GET_POI_OSM_VECTOR_KERNELS 1
+#if defined(__x86_64__) || defined(__i386__)
+#define GET_POI_OSM_X86_KERNELS 1
+#endif
+#endif
+
+namespace {
+
+using Terms = geo::RadiusFilter::Terms;
+
+constexpr double kRadiansPerUnit = geo::kCoordinateUnit * std::numbers::pi / 180.0;
+
+// The pre-filter bounds are widened by this share, far above their rounding
+// error, so it never drops a point on the circle
+constexpr double kBoundSlack = 1e-9;
+
+// Bounds are kept above this so their reciprocals stay finite
+constexpr double kTinyBound = 1e-300;
+
+// Taylor coefficients of sin(x) / x and cos(x) in powers of x^2. The kernels
+// only see |x| <= pi/2, where the first omitted terms are below 3e-16.
+constexpr std::size_t kTerms = 11;
+
+constexpr std::array<double, kTerms> taylor(int firstPower) {
+    std::array<double, kTerms> c{};
+    double term = 1.0;
+    for (int n = 2; n <= firstPower; ++n) term /= n;
+    for (std::size_t k = 0; k < kTerms; ++k) {
+        c[k] = term;
+        int n = firstPower + 2 * static_cast<int>(k);
+        term = -term / ((n + 1) * (n + 2));
+    }
+    return c;
+}
+
+constexpr auto kSine = taylor(1);
+constexpr auto kCosine = taylor(0);
+
+// Coefficients of asin(sqrt(a)) / sqrt(a) in powers of a, used for
+// haversine terms up to kSeriesLimit (distances up to about 2250 km), where
+// the first omitted term is below 1e-17
+constexpr std::array<double, kTerms> kArcsine = [] {
+    std::array<double, kTerms> c{};
+    c[0] = 1.0;
+    for (std::size_t n = 1; n < kTerms; ++n) {
+        double odd = 2.0 * n - 1;
+        c[n] = c[n - 1] * odd * odd / (2.0 * n * (2.0 * n + 1));
+    }
+    return c;
+}();
+constexpr double kSeriesLimit = 1.0 / 32;
+
+#if GET_POI_OSM_VECTOR_KERNELS
+typedef double Doubles2 __attribute__((vector_size(16)));
+typedef double Doubles4 __attribute__((vector_size(32)));
+typedef double Doubles8 __attribute__((vector_size(64)));
+typedef std::int32_t Ints2 __attribute__((vector_size(8)));
+typedef std::int32_t Ints4 __attribute__((vector_size(16)));
+typedef std::int32_t Ints8 __attribute__((vector_size(32)));
+#endif
+
+// The kernel below is written once for plain doubles and for vectors of
+// them; these helpers cover the few operations that differ. Everything is
+// inlined into the kernel, so vectors never cross a function boundary
+// compiled without the instruction set they need, and GCC's note that
+// such a boundary would change the ABI does not apply.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+template <typename D>
+constexpr std::size_t kLanes = sizeof(D) / sizeof(double);
+
+template <typename D, typename I>
+[[gnu::always_inline]] inline D toDoubles(const I& ints) {
+    if constexpr (std::is_same_v<D, double>) {
+        return static_cast<double>(ints);
+    } else {
+        return __builtin_convertvector(ints, D);
+    }
+}
+
+template <typename D>
+[[gnu::always_inline]] inline D smaller(const D& a, const D& b) {
+    return a < b ? a : b;
+}
+
+template <typename D>
+[[gnu::always_inline]] inline D larger(const D& a, const D& b) {
+    return a < b ? b : a;
+}
+
+template <typename D>
+[[gnu::always_inline]] inline double smallestLane(const D& values) {
+    if constexpr (std::is_arithmetic_v<D>) {
+        return values;
+    } else {
+        // Fold the upper half of the lanes onto the lower until one is left
+        D folded = values;
+        if constexpr (kLanes<D> == 8) {
+            folded = smaller(folded, __builtin_shufflevector(folded, folded, 4, 5, 6, 7, 0, 1, 2, 3));
+            folded = smaller(folded, __builtin_shufflevector(folded, folded, 2, 3, 0, 1, 6, 7, 4, 5));
+        } else if constexpr (kLanes<D> == 4) {
+            folded = smaller(folded, __builtin_shufflevector(folded, folded, 2, 3, 0, 1));
+        }
+        return std::min(folded[0], folded[1]);
+    }
+}
+
+template <typename V>
+[[gnu::always_inline]] inline auto lane(const V& values, std::size_t k) {
+    if constexpr (std::is_arithmetic_v<V>) {
+        return values;
+    } else {
+        return values[k];
+    }
+}
+
+// Horner's scheme in x^2
+template <typename D>
+[[gnu::always_inline]] inline D polynomial(const std::array<double, kTerms>& c, const D& x2) {
+    D sum = x2 * 0.0 + c[kTerms - 1];
+    for (std::size_t k = kTerms - 1; k-- > 0;) sum = sum * x2 + c[k];
+    return sum;
+}
+
+template <typename D, typename I>
+[[gnu::always_inline]] inline std::size_t filterLanes(Terms t, const std::int32_t* lats,
+                                                      const std::int32_t* lons, std::size_t count,
+                                                      std::uint32_t* indices, double* distances) {
+    constexpr std::size_t W = kLanes<D>;
+    constexpr double pi = std::numbers::pi;
+    std::size_t found = 0;
+    std::array<std::int32_t, W> tailLats{};
+    std::array<std::int32_t, W> tailLons{};
+    for (std::size_t base = 0; base < count; base += W) {
+        // The last, partial vector is read from zero-padded copies
+        std::size_t valid = std::min(W, count - base);
+        const std::int32_t* latSource = lats + base;
+        const std::int32_t* lonSource = lons + base;
+        if (valid < W) {
+            std::copy_n(latSource, valid, tailLats.begin());
+            std::copy_n(lonSource, valid, tailLons.begin());
+            latSource = tailLats.data();
+            lonSource = tailLons.data();
+        }
+        I latUnits;
+        I lonUnits;
+        std::memcpy(&latUnits, latSource, sizeof(latUnits));
+        std::memcpy(&lonUnits, lonSource, sizeof(lonUnits));
+
+        // Pre-filter: the bounding box and the equirectangular lower bound
+        D lat = toDoubles<D>(latUnits);
+        D dLat = (lat - t.lat) * kRadiansPerUnit;
+        D dLon = (toDoubles<D>(lonUnits) - t.lon) * kRadiansPerUnit;
+        dLon = dLon > pi ? dLon - 2 * pi : (dLon < -pi ? dLon + 2 * pi : dLon);
+        D absLat = dLat < 0.0 ? -dLat : dLat;
+        D absLon = dLon < 0.0 ? -dLon : dLon;
+        // The largest of the offsets and the equirectangular term, each
+        // relative to its bound, is at most 1 for the points that may be
+        // inside. Comparing one value instead of combining three masks
+        // keeps GCC from splitting the comparisons into lanes.
+        D excess = larger(larger(absLat * t.latScale, absLon * t.lonScale),
+                          (dLat * dLat + t.bandWeight * dLon * dLon) * t.equirectScale);
+        if (smallestLane(excess) > 1.0) continue;
+
+        // Exact haversine term
+        D halfLat = dLat * 0.5;
+        D halfLon = dLon * 0.5;
+        D sinLat = halfLat * polynomial(kSine, halfLat * halfLat);
+        D sinLon = halfLon * polynomial(kSine, halfLon * halfLon);
+        lat *= kRadiansPerUnit;
+        D a = sinLat * sinLat + t.cosLat * polynomial(kCosine, lat * lat) * sinLon * sinLon;
+
+        D arcsine = polynomial(kArcsine, a);
+
+        for (std::size_t k = 0; k < valid; ++k) {
+            if (lane(excess, k) > 1.0 || lane(a, k) > t.maxHaversine) continue;
+            indices[found] = static_cast<std::uint32_t>(base + k);
+            if (distances) {
+                double term = std::clamp(lane(a, k), 0.0, 1.0);
+                double angle = term <= kSeriesLimit ? std::sqrt(term) * lane(arcsine, k) : std::asin(std::sqrt(term));
+                distances[found] = 2.0 * geo::kEarthRadiusMeters * angle;
+            }
+            ++found;
+        }
+    }
+    return found;
+}
+
+using Kernel = geo::RadiusFilter::Kernel;
+
+std::size_t filterScalar(const Terms& t, const std::int32_t* lats, const std::int32_t* lons, std::size_t count,
+                         std::uint32_t* indices, double* distances) {
+    return filterLanes<double, std::int32_t>(t, lats, lons, count, indices, distances);
+}
+
+#if GET_POI_OSM_VECTOR_KERNELS
+#if GET_POI_OSM_X86_KERNELS
+[[gnu::target("sse2")]]
+#endif
+std::size_t filter128(const Terms& t, const std::int32_t* lats, const std::int32_t* lons, std::size_t count,
+                      std::uint32_t* indices, double* distances) {
+    return filterLanes<Doubles2, Ints2>(t, lats, lons, count, indices, distances);
+}
+#endif
+
+#if GET_POI_OSM_X86_KERNELS
+[[gnu::target("avx2")]]
+std::size_t filterAvx2(const Terms& t, const std::int32_t* lats, const std::int32_t* lons, std::size_t count,
+                       std::uint32_t* indices, double* distances) {
+    return filterLanes<Doubles4, Ints4>(t, lats, lons, count, indices, distances);
+}
+
+[[gnu::target("avx512f,avx512dq")]]
+std::size_t filterAvx512(const Terms& t, const std::int32_t* lats, const std::int32_t* lons, std::size_t count,
+                         std::uint32_t* indices, double* distances) {
+    return filterLanes<Doubles8, Ints8>(t, lats, lons, count, indices, distances);
+}
+#endif
+
+} // namespace
+
+namespace geo {
+
+RadiusFilter::Kernel RadiusFilter::bestKernel() {
+#if GET_POI_OSM_X86_KERNELS
+    static const Kernel best = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) return Kernel::kAvx512;
+        if (__builtin_cpu_supports("avx2")) return Kernel::kAvx2;
+        if (__builtin_cpu_supports("sse2")) return Kernel::kSse2;
+        return Kernel::kScalar;
+    }();
+    return best;
+#elif GET_POI_OSM_VECTOR_KERNELS
+    return Kernel::kSse2;
+#else
+    return Kernel::kScalar;
+#endif
+}
+
+std::string_view RadiusFilter::kernelName(Kernel kernel) {
+    switch (kernel) {
+    case Kernel::kScalar:
+        return "scalar";
+    case Kernel::kSse2:
+#if GET_POI_OSM_X86_KERNELS
+        return "sse2";
+#else
+        return "simd128";
+#endif
+    case Kernel::kAvx2:
+        return "avx2";
+    case Kernel::kAvx512:
+        return "avx512";
+    }
+    return "scalar";
+}
+
+RadiusFilter::RadiusFilter(double lat, double lon, double radiusMeters, Kernel kernel)
+    : kernel_(std::min(kernel, bestKernel())) {
+    double angle = std::clamp(radiusMeters / kEarthRadiusMeters, 0.0, std::numbers::pi);
+    double latRadians = toRadians(lat);
+    terms_.lat = lat / kCoordinateUnit;
+    terms_.lon = lon / kCoordinateUnit;
+    terms_.cosLat = std::cos(latRadians);
+    double maxDLat = angle * (1 + kBoundSlack);
+
+    // Widest longitude offset of the circle, as in tiles::circleBounds(),
+    // or any longitude once the circle reaches a pole
+    double maxDLon = std::numbers::pi;
+    if (angle + std::fabs(latRadians) < std::numbers::pi / 2) {
+        maxDLon = std::asin(std::sin(angle) / terms_.cosLat) * (1 + kBoundSlack);
+    }
+
+    // sin(x) >= x (1 - x^2 / 6) for the half offsets x the box leaves, and
+    // cos(lat) of a point in the box is at least the cosine at its edge
+    // nearer a pole, which bounds the haversine term from below by a scaled
+    // equirectangular distance
+    double cosEdge = std::cos(std::min(std::fabs(latRadians) + maxDLat, std::numbers::pi / 2));
+    terms_.bandWeight = terms_.cosLat * std::max(cosEdge, 0.0);
+    double sinHalf = std::sin(angle / 2);
+    terms_.maxHaversine = sinHalf * sinHalf;
+    double half = std::max(maxDLat, maxDLon) / 2;
+    double shrink = (1 - half * half / 6) * (1 - half * half / 6);
+    double maxEquirect = 4 * terms_.maxHaversine / shrink * (1 + kBoundSlack);
+
+    // The kernels multiply by the reciprocals; a zero radius leaves only
+    // offsets of zero at most 1
+    terms_.latScale = 1 / std::max(maxDLat, kTinyBound);
+    terms_.lonScale = 1 / std::max(maxDLon, kTinyBound);
+    terms_.equirectScale = 1 / std::max(maxEquirect, kTinyBound);
+}
+
+std::size_t RadiusFilter::filter(const std::int32_t* lats, const std::int32_t* lons, std::size_t count,
+                                 std::uint32_t* indices, double* distances) const {
+    switch (kernel_) {
+#if GET_POI_OSM_X86_KERNELS
+    case Kernel::kAvx512:
+        return filterAvx512(terms_, lats, lons, count, indices, distances);
+    case Kernel::kAvx2:
+        return filterAvx2(terms_, lats, lons, count, indices, distances);
+#endif
+#if GET_POI_OSM_VECTOR_KERNELS
+    case Kernel::kSse2:
+        return filter128(terms_, lats, lons, count, indices, distances);
+#endif
+    default:
+        return filterScalar(terms_, lats, lons, count, indices, distances);
+    }
+}
+
+} // namespace geo
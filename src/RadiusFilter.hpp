@@ -0,0 +1,99 @@
+/**
+ * SPDX-FileComment: Internal header for the vectorized radius filter
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file RadiusFilter.hpp
+ * @brief Defines geo::RadiusFilter, which selects the points of quantized
+ * coordinate columns within a radius, with a kernel chosen at runtime.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace geo {
+
+/**
+ * @brief Finds the points within a radius of a center, many at a time.
+ *
+ * Points are given as columns of int32 latitudes and longitudes in
+ * kCoordinateUnit (structure of arrays). Each point goes through:
+ * 1. A pre-filter: the bounding box of the circle and an equirectangular
+ *    lower bound of the distance, using cos(lat0) and the smallest cosine
+ *    of the circle's latitudes, a few multiplications. Vectors whose
+ *    points all fail it skip the rest.
+ * 2. The exact haversine term sin²(dLat/2) + cos(lat0) cos(lat) sin²(dLon/2),
+ *    with cos(lat0) computed once per filter, compared with the term of the
+ *    radius, so no arcsine is needed to decide.
+ * 3. The distance, 2R asin(sqrt(term)), for the points inside only.
+ *
+ * The kernel is chosen once, at runtime: AVX-512 (8 points per step), AVX2
+ * (4), SSE2 or the target's other 128-bit vectors (2), or scalar code.
+ * All of them evaluate the same polynomials for sine and cosine on the
+ * ranges the pre-filter leaves (relative error below 1e-15), so they
+ * agree with each other and with geo::haversineMeters() far below the
+ * 1 cm of coordinate precision.
+ */
+class RadiusFilter {
+public:
+    /// Instruction sets of the kernels, in increasing width.
+    enum class Kernel { kScalar, kSse2, kAvx2, kAvx512 };
+
+    /// The widest kernel this CPU supports.
+    static Kernel bestKernel();
+
+    /// Name of a kernel, for reports.
+    static std::string_view kernelName(Kernel kernel);
+
+    /**
+     * @param lat Latitude of the center.
+     * @param lon Longitude of the center.
+     * @param radiusMeters Radius of the circle.
+     * @param kernel Kernel to use; one the CPU lacks falls back to bestKernel().
+     */
+    RadiusFilter(double lat, double lon, double radiusMeters, Kernel kernel = bestKernel());
+
+    /// The kernel in use.
+    Kernel kernel() const { return kernel_; }
+
+    /**
+     * @brief Selects the points within the radius.
+     *
+     * @param lats Quantized latitude per point.
+     * @param lons Quantized longitude per point.
+     * @param count Number of points; at most 2^32.
+     * @param indices Receives the indices of the points inside, ascending; room for @p count.
+     * @param distances Receives their distances in meters; room for @p count, or null if not needed.
+     * @return std::size_t Number of points inside.
+     */
+    std::size_t filter(const std::int32_t* lats, const std::int32_t* lons, std::size_t count,
+                       std::uint32_t* indices, double* distances) const;
+
+    /// Terms shared by all points, computed once by the constructor; used by the kernels.
+    struct Terms {
+        double lat;           // Center, in kCoordinateUnit
+        double lon;
+        double cosLat;        // cos(lat0)
+        double latScale;      // 1 / half height of the bounding box, in radians
+        double lonScale;      // 1 / half width of the bounding box, in radians
+        double bandWeight;    // cos(lat0) times the smallest cosine of the box's latitudes
+        double equirectScale; // 1 / largest dLat^2 + bandWeight dLon^2 of a point inside
+        double maxHaversine;  // Haversine term of the radius
+    };
+
+private:
+    Terms terms_;
+    Kernel kernel_;
+};
+
+} // namespace geo
@@ -0,0 +1,71 @@
+/**
+ * SPDX-FileComment: Internal header for awaitable reactor transfers
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file ReactorFetch.hpp
+ * @brief Defines PoiOsmReactor::FetchAwaiter, the awaitable HTTP transfer
+ * used by the coroutine API of PoiOsmClient.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <coroutine>
+#include <expected>
+#include <string>
+
+#include "CurlPool.hpp"
+#include "PoiOsmReactor.hpp"
+
+/**
+ * @brief One HTTP transfer on a PoiOsmReactor, resumed when it finishes.
+ *
+ * The awaiter lives in the awaiting coroutine's frame for the duration of
+ * the transfer, so the reactor only keeps a pointer to it.
+ */
+class PoiOsmReactor::FetchAwaiter {
+public:
+    FetchAwaiter(PoiOsmReactor& reactor, CurlPool::Lease handle, std::string url, std::string postData,
+                 CurlPool::ChunkSink sink = {})
+        : reactor_(reactor), handle_(std::move(handle)), url_(std::move(url)), postData_(std::move(postData)),
+          sink_(std::move(sink)) {}
+
+    FetchAwaiter(const FetchAwaiter&) = delete;
+    FetchAwaiter& operator=(const FetchAwaiter&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+
+    /**
+     * @brief Registers the transfer with the reactor's multi handle.
+     *
+     * @return bool false if the transfer could not be started (resume immediately).
+     */
+    bool await_suspend(std::coroutine_handle<> awaiter);
+
+    std::expected<std::string, std::string> await_resume() { return std::move(result_); }
+
+    /**
+     * @brief Called by the reactor when the transfer finished.
+     *
+     * @param code The transfer's CURLcode.
+     * @return std::coroutine_handle<> The coroutine to resume.
+     */
+    std::coroutine_handle<> complete(CURLcode code);
+
+private:
+    PoiOsmReactor& reactor_;
+    CurlPool::Lease handle_;
+    std::string url_;
+    std::string postData_;
+    CurlPool::ChunkSink sink_;
+    std::string body_;
+    std::expected<std::string, std::string> result_;
+    std::coroutine_handle<> awaiter_;
+};
@@ -0,0 +1,139 @@
+/**
+ * SPDX-FileComment: Implementation of the spatial Overpass result cache
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file SpatialCache.cpp
+ * @brief  Implements SpatialCache containment lookups and local filtering.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "SpatialCache.hpp"
+#include "Geo.hpp"
+#include "Whitelist.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// Absorbs rounding in the containment test (coordinates are sent with 6 decimals)
+constexpr double kContainmentSlackMeters = 0.5;
+
+// Cells of about 870 m: cached circles are small
+constexpr std::uint32_t kCellsPerDegree = grid::kMaxCellsPerDegree;
+
+// The index sees coordinates rounded to geo::kCoordinateUnit (about 1 cm), so
+// its distances are within this much of those of the cached coordinates
+constexpr double kQuantizationSlackMeters = 0.05;
+
+} // namespace
+
+SpatialCache::SpatialCache(std::size_t capacity, std::chrono::seconds ttl, bool tagged)
+    : capacity_(capacity), ttl_(ttl), tagged_(tagged) {}
+
+std::optional<SpatialCache::Match> SpatialCache::lookup(double lat, double lon, int radiusMeters,
+                                                        const std::vector<PoiWhitelistEntry>& whitelist) {
+    if (capacity_ == 0) return std::nullopt;
+
+    std::string whitelistKey = whitelist::canonical(whitelist);
+    std::lock_guard lock(mutex_);
+    auto now = Clock::now();
+
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (now >= it->expires) {
+            it = entries_.erase(it);
+            ++stats_.expirations;
+            continue;
+        }
+
+        double centerDistance = geo::haversineMeters(it->lat, it->lon, lat, lon);
+        bool contained = centerDistance + radiusMeters <= it->radiusMeters + kContainmentSlackMeters;
+
+        // Every cached POI matches its own whitelist, so only a narrower one needs the tags
+        bool sameWhitelist = it->whitelistKey == whitelistKey;
+        if (!contained || !(sameWhitelist || (tagged_ && whitelist::covers(it->whitelist, whitelist)))) {
+            ++it;
+            continue;
+        }
+
+        static const nlohmann::json noTags = nlohmann::json::object();
+        const whitelist::Matcher matcher(whitelist);
+        // Candidates keep the order of the cached result
+        std::vector<std::pair<std::size_t, double>> candidates;
+        it->index.circle(lat, lon, radiusMeters + kQuantizationSlackMeters,
+                         [&](std::size_t i, double distance) { candidates.emplace_back(it->order[i], distance); });
+        std::ranges::sort(candidates);
+
+        // Only candidates within the slack of the radius are measured again, from the cached coordinates
+        Match match{nlohmann::json::array(), {}};
+        match.distances.reserve(candidates.size());
+        for (auto [c, distance] : candidates) {
+            const auto& poi = it->pois[c];
+            if (distance > radiusMeters - kQuantizationSlackMeters) {
+                distance = geo::haversineMeters(lat, lon, poi.value("lat", 0.0), poi.value("lon", 0.0));
+                if (distance > radiusMeters) continue;
+            }
+            if (auto tags = poi.find("tags"); !sameWhitelist && !matcher.matches(tags != poi.end() ? *tags : noTags)) {
+                continue;
+            }
+            match.pois.push_back(poi);
+            match.distances.push_back(distance);
+        }
+
+        // Estimate the avoided download by the share of the cached POIs served
+        if (!it->pois.empty()) {
+            stats_.bytesSaved += it->responseBytes * match.pois.size() / it->pois.size();
+        }
+        ++stats_.hits;
+        entries_.splice(entries_.begin(), entries_, it);
+        return match;
+    }
+
+    ++stats_.misses;
+    return std::nullopt;
+}
+
+void SpatialCache::store(double lat, double lon, int radiusMeters,
+                         const std::vector<PoiWhitelistEntry>& whitelist,
+                         const nlohmann::json& pois, std::size_t responseBytes) {
+    if (capacity_ == 0) return;
+
+    Entry entry{lat, lon, radiusMeters, whitelist, whitelist::canonical(whitelist), pois, responseBytes,
+                Clock::now() + ttl_, {}, {}, {}, {}, {}};
+    std::vector<std::int32_t> lats;
+    std::vector<std::int32_t> lons;
+    lats.reserve(pois.size());
+    lons.reserve(pois.size());
+    for (const auto& poi : pois) {
+        lats.push_back(geo::quantize(poi.value("lat", 0.0)));
+        lons.push_back(geo::quantize(poi.value("lon", 0.0)));
+    }
+    GridIndex::build(lats, lons, kCellsPerDegree, entry.order, entry.cells);
+    for (std::size_t i : entry.order) {
+        entry.lats.push_back(lats[i]);
+        entry.lons.push_back(lons[i]);
+    }
+    // Moving the vectors keeps their buffers, which the index points into
+    entry.index = GridIndex(entry.lats.data(), entry.lons.data(), entry.order.size(), entry.cells.data(),
+                            entry.cells.size(), kCellsPerDegree);
+
+    std::lock_guard lock(mutex_);
+    if (entries_.size() >= capacity_) {
+        entries_.pop_back();
+        ++stats_.evictions;
+    }
+    entries_.push_front(std::move(entry));
+}
+
+PoiCacheStats SpatialCache::stats() const {
+    std::lock_guard lock(mutex_);
+    PoiCacheStats snapshot = stats_;
+    snapshot.entries = entries_.size();
+    return snapshot;
+}
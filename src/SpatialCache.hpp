@@ -0,0 +1,122 @@
+/**
+ * SPDX-FileComment: Internal header for the spatial Overpass result cache
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file SpatialCache.hpp
+ * @brief Defines the SpatialCache class that answers queries from cached
+ * results of enclosing circles.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "GridIndex.hpp"
+#include "PoiOsm.hpp"
+
+/**
+ * @brief Cache of Overpass results keyed by (center, radius, whitelist).
+ *
+ * A lookup hits when the requested circle lies completely inside a cached
+ * circle and the cached whitelist accepts everything the requested one
+ * accepts. The answer is then computed locally by filtering the cached POIs
+ * by distance and by the requested whitelist. Each entry keeps a
+ * GridIndex over its POIs, so a small circle inside a large cached one
+ * only looks at the POIs near it, and the distances its vectorized filter
+ * measures are handed out with the POIs. All methods are safe to call from
+ * several threads.
+ */
+class SpatialCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// POIs answering a lookup.
+    struct Match {
+        nlohmann::json pois;           ///< The matching POIs, in the order of the cached result.
+        std::vector<double> distances; ///< Distance of each POI from the requested center, in meters.
+    };
+
+    /**
+     * @brief Creates a cache.
+     *
+     * @param capacity Maximum number of cached circles; 0 disables the cache.
+     * @param ttl Lifetime of a cached result.
+     * @param tagged false if the cached POIs carry no tags (`out skel`), so
+     * only queries with the same whitelist can be answered.
+     */
+    SpatialCache(std::size_t capacity, std::chrono::seconds ttl, bool tagged = true);
+
+    /**
+     * @brief Answers a query from an enclosing cached circle.
+     *
+     * @param lat Latitude of the requested center.
+     * @param lon Longitude of the requested center.
+     * @param radiusMeters Requested radius.
+     * @param whitelist Requested whitelist.
+     * @return std::optional<Match> The matching POIs, or std::nullopt on a miss.
+     */
+    std::optional<Match> lookup(double lat, double lon, int radiusMeters,
+                                const std::vector<PoiWhitelistEntry>& whitelist);
+
+    /**
+     * @brief Caches the POIs of a completed query.
+     *
+     * @param lat Latitude of the center.
+     * @param lon Longitude of the center.
+     * @param radiusMeters Radius of the query.
+     * @param whitelist Whitelist of the query.
+     * @param pois The result's POIs array (each with lat, lon and tags).
+     * @param responseBytes Size of the Overpass response the POIs came from.
+     */
+    void store(double lat, double lon, int radiusMeters,
+               const std::vector<PoiWhitelistEntry>& whitelist,
+               const nlohmann::json& pois, std::size_t responseBytes);
+
+    /**
+     * @brief Returns a snapshot of the hit/miss and bytes saved counters.
+     */
+    PoiCacheStats stats() const;
+
+private:
+    struct Entry {
+        double lat;
+        double lon;
+        int radiusMeters;
+        std::vector<PoiWhitelistEntry> whitelist;
+        std::string whitelistKey; // whitelist::canonical() of whitelist
+        nlohmann::json pois;
+        std::size_t responseBytes;
+        Clock::time_point expires;
+
+        // Coordinates of the POIs in cell order; order[i] is the index in pois of point i
+        std::vector<std::int32_t> lats;
+        std::vector<std::int32_t> lons;
+        std::vector<std::size_t> order;
+        std::vector<grid::Cell> cells;
+        GridIndex index; // over lats and lons, so it must not outlive them
+    };
+
+    std::size_t capacity_;
+    std::chrono::seconds ttl_;
+    bool tagged_;
+
+    mutable std::mutex mutex_;
+    std::list<Entry> entries_; // most recently used first
+    PoiCacheStats stats_;
+};
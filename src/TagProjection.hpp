@@ -0,0 +1,62 @@
+/**
+ * SPDX-FileComment: Internal header for the tag projection
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file TagProjection.hpp
+ * @brief Defines TagProjection, the set of tags kept per POI
+ * (PoiOsmClientOptions::tags).
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "PoiOsm.hpp"
+
+/**
+ * @brief Decides which tags of an element are kept.
+ *
+ * The keys of the whitelist are always kept along with the requested tags:
+ * they show which entry a POI matched, and the result cache needs them to
+ * answer narrower whitelists later.
+ */
+class TagProjection {
+public:
+    /**
+     * @brief Creates a projection.
+     *
+     * @param tags The tags to keep; std::nullopt keeps every tag.
+     * @param whitelist The whitelist of the query.
+     */
+    TagProjection(const std::optional<std::vector<std::string>>& tags,
+                  const std::vector<PoiWhitelistEntry>& whitelist)
+        : keepsAll_(!tags) {
+        if (!tags) return;
+        keys_.insert(tags->begin(), tags->end());
+        for (const auto& w : whitelist) keys_.insert(w.key);
+    }
+
+    /// Whether the tag @p key is kept.
+    bool keeps(std::string_view key) const { return keepsAll_ || keys_.contains(key); }
+
+private:
+    struct Hash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    bool keepsAll_;
+    std::unordered_set<std::string, Hash, std::equal_to<>> keys_;
+};
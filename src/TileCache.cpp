@@ -0,0 +1,34 @@
+/**
+ * SPDX-FileComment: Implementation of the per-tile Overpass cache
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file TileCache.cpp
+ * @brief  Implements the TileCache on top of LruCache.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include "TileCache.hpp"
+
+#include <utility>
+
+TileCache::TileCache(std::size_t capacity, std::chrono::seconds ttl)
+    : ttl_(ttl), tiles_(capacity) {}
+
+TileCache::Elements TileCache::lookup(const std::string& key) {
+    return tiles_.lookup(key).value_or(nullptr);
+}
+
+void TileCache::store(const std::string& key, Elements elements) {
+    tiles_.store(key, std::move(elements), ttl_);
+}
+
+PoiCacheStats TileCache::stats() const {
+    return tiles_.stats();
+}
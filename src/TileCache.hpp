@@ -0,0 +1,67 @@
+/**
+ * SPDX-FileComment: Internal header for the per-tile Overpass cache
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file TileCache.hpp
+ * @brief Defines the TileCache class, a bounded LRU of Overpass elements
+ * per (tile, whitelist).
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <nlohmann/json.hpp>
+
+#include "LruCache.hpp"
+#include "PoiOsm.hpp"
+
+/**
+ * @brief Bounded LRU cache of the Overpass elements of single tiles.
+ *
+ * Keys combine the tile's quadkey with the canonical whitelist, so
+ * overlapping queries from different centers share tile fetches. Cached
+ * element arrays are immutable and handed out as shared pointers. All
+ * methods are safe to call from several threads.
+ */
+class TileCache {
+public:
+    using Elements = std::shared_ptr<const nlohmann::json>;
+
+    /**
+     * @brief Creates a cache.
+     *
+     * @param capacity Maximum number of cached tiles; 0 disables the cache.
+     * @param ttl Lifetime of a cached tile.
+     */
+    TileCache(std::size_t capacity, std::chrono::seconds ttl);
+
+    /**
+     * @brief Returns the cached elements of a tile, or nullptr on a miss.
+     */
+    Elements lookup(const std::string& key);
+
+    /**
+     * @brief Caches the elements of a tile.
+     */
+    void store(const std::string& key, Elements elements);
+
+    /**
+     * @brief Returns a snapshot of the hit/miss counters.
+     */
+    PoiCacheStats stats() const;
+
+private:
+    std::chrono::seconds ttl_;
+    LruCache<Elements> tiles_;
+};
@@ -0,0 +1,193 @@
+/**
+ * SPDX-FileComment: Internal header with Web Mercator tile helpers
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file Tiles.hpp
+ * @brief Quadkey tiling of search circles for tiled Overpass fetching.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <string>
+#include <vector>
+
+#include "Geo.hpp"
+
+namespace tiles {
+
+/// Latitude limit of the Web Mercator projection.
+inline constexpr double kMaxLatitude = 85.05112878;
+
+/**
+ * @brief Geographic bounding box in degrees.
+ */
+struct BBox {
+    double south;
+    double west;
+    double north;
+    double east;
+};
+
+/**
+ * @brief Web Mercator (slippy map) tile address.
+ */
+struct TileId {
+    int zoom;
+    int x;
+    int y;
+};
+
+inline int latToTileY(double lat, int zoom) {
+    int n = 1 << zoom;
+    double latRad = geo::toRadians(std::clamp(lat, -kMaxLatitude, kMaxLatitude));
+    double y = (1.0 - std::asinh(std::tan(latRad)) / std::numbers::pi) / 2.0 * n;
+    return std::clamp(static_cast<int>(std::floor(y)), 0, n - 1);
+}
+
+/**
+ * @brief Returns the bounding box covered by a tile.
+ */
+inline BBox bounds(const TileId& tile) {
+    double n = static_cast<double>(1 << tile.zoom);
+    auto lat = [n](int y) {
+        return std::atan(std::sinh(std::numbers::pi * (1.0 - 2.0 * y / n))) * 180.0 / std::numbers::pi;
+    };
+    return BBox{lat(tile.y + 1), tile.x / n * 360.0 - 180.0, lat(tile.y), (tile.x + 1) / n * 360.0 - 180.0};
+}
+
+/**
+ * @brief Returns the Bing-style quadkey of a tile, e.g. "1202" at zoom 4.
+ */
+inline std::string quadkey(const TileId& tile) {
+    std::string key;
+    key.reserve(static_cast<std::size_t>(tile.zoom));
+    for (int level = tile.zoom; level > 0; --level) {
+        int mask = 1 << (level - 1);
+        char digit = '0';
+        if (tile.x & mask) digit += 1;
+        if (tile.y & mask) digit += 2;
+        key += digit;
+    }
+    return key;
+}
+
+/**
+ * @brief Returns the bounding box of a circle.
+ *
+ * Longitudes are not wrapped: the box of a circle crossing the antimeridian
+ * reaches below -180 or above 180. splitAntimeridian() cuts it into boxes
+ * within ±180.
+ */
+inline BBox circleBounds(double lat, double lon, double radiusMeters) {
+    double angle = radiusMeters / geo::kEarthRadiusMeters;
+    double dLat = angle * 180.0 / std::numbers::pi;
+    // Widest longitude offset of the circle, reached slightly poleward of its center
+    double sinLon = std::sin(angle) / std::max(std::cos(geo::toRadians(lat)), 1e-9);
+    double dLon = sinLon >= 1.0 ? 180.0 : std::asin(sinLon) * 180.0 / std::numbers::pi;
+    return BBox{std::max(lat - dLat, -kMaxLatitude), lon - dLon, std::min(lat + dLat, kMaxLatitude), lon + dLon};
+}
+
+/**
+ * @brief Cuts a box reaching past ±180 at the antimeridian.
+ *
+ * @return std::vector<BBox> The box itself if it lies within ±180, the whole
+ * longitude range if it spans all of it, or the two pieces on either side.
+ */
+inline std::vector<BBox> splitAntimeridian(const BBox& box) {
+    if (box.east - box.west >= 360.0) return {BBox{box.south, -180.0, box.north, 180.0}};
+    if (box.west < -180.0) {
+        return {BBox{box.south, box.west + 360.0, box.north, 180.0}, BBox{box.south, -180.0, box.north, box.east}};
+    }
+    if (box.east > 180.0) {
+        return {BBox{box.south, box.west, box.north, 180.0}, BBox{box.south, -180.0, box.north, box.east - 360.0}};
+    }
+    return {box};
+}
+
+/**
+ * @brief Returns a lower bound of the haversine term from a point to a box.
+ *
+ * The term sin²(dLat/2) + cos(lat) cos(lat2) sin²(dLon/2) is bounded from
+ * below part by part: the latitude gap by the nearest edge, the longitude
+ * gap the shorter way around the globe, and cos(lat2) by the box latitude
+ * nearest a pole. Compare it with the term of a radius, or convert it with
+ * 2R asin(sqrt(term)).
+ *
+ * @param lat Latitude of the point.
+ * @param lon Longitude of the point.
+ * @param cosLat cos(lat), computed once by the caller.
+ * @param box The box; its edges may lie beyond ±90 and ±180.
+ * @return double The smallest term of any point of the box.
+ */
+inline double minHaversine(double lat, double lon, double cosLat, const BBox& box) {
+    double south = std::clamp(box.south, -90.0, 90.0);
+    double north = std::clamp(box.north, -90.0, 90.0);
+    double dLat = lat < south ? south - lat : (lat > north ? lat - north : 0.0);
+    double dLon = 0.0;
+    if (lon < box.west) dLon = std::max(std::min(box.west - lon, lon + 360.0 - box.east), 0.0);
+    if (lon > box.east) dLon = std::max(std::min(lon - box.east, box.west + 360.0 - lon), 0.0);
+    if (dLat == 0.0 && dLon == 0.0) return 0.0;
+
+    double sinLat = std::sin(geo::toRadians(dLat) / 2);
+    if (dLon == 0.0) return sinLat * sinLat;
+    double cosBox = std::cos(geo::toRadians(std::max(std::fabs(south), std::fabs(north))));
+    double sinLon = std::sin(geo::toRadians(std::min(dLon, 180.0)) / 2);
+    return sinLat * sinLat + cosLat * std::max(cosBox, 0.0) * sinLon * sinLon;
+}
+
+/**
+ * @brief Splits a bounding box into its four quadrants.
+ */
+inline std::array<BBox, 4> quadrants(const BBox& box) {
+    double midLat = (box.south + box.north) / 2.0;
+    double midLon = (box.west + box.east) / 2.0;
+    return {BBox{box.south, box.west, midLat, midLon}, BBox{box.south, midLon, midLat, box.east},
+            BBox{midLat, box.west, box.north, midLon}, BBox{midLat, midLon, box.north, box.east}};
+}
+
+/**
+ * @brief Returns all tiles of the given zoom level that intersect a circle.
+ *
+ * @param lat Latitude of the center.
+ * @param lon Longitude of the center.
+ * @param radiusMeters Radius of the circle.
+ * @param zoom Tile zoom level.
+ * @return std::vector<TileId> The covering tiles.
+ */
+inline std::vector<TileId> coverCircle(double lat, double lon, double radiusMeters, int zoom) {
+    BBox box = circleBounds(lat, lon, radiusMeters);
+    // Columns of the unwrapped box: those left of 0 or right of n - 1 lie
+    // across the antimeridian and wrap around
+    int n = 1 << zoom;
+    int minX = static_cast<int>(std::floor((box.west + 180.0) / 360.0 * n));
+    int maxX = std::min(static_cast<int>(std::floor((box.east + 180.0) / 360.0 * n)), minX + n - 1);
+    int minY = latToTileY(box.north, zoom);
+    int maxY = latToTileY(box.south, zoom);
+
+    double cosLat = std::cos(geo::toRadians(lat));
+    double angle = std::min(radiusMeters / geo::kEarthRadiusMeters, std::numbers::pi);
+    double maxHaversine = std::sin(angle / 2) * std::sin(angle / 2);
+
+    std::vector<TileId> result;
+    for (int y = minY; y <= maxY; ++y) {
+        for (int x = minX; x <= maxX; ++x) {
+            TileId tile{zoom, (x % n + n) % n, y};
+            if (minHaversine(lat, lon, cosLat, bounds(tile)) <= maxHaversine) result.push_back(tile);
+        }
+    }
+    return result;
+}
+
+} // namespace tiles
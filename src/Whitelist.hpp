@@ -0,0 +1,162 @@
+/**
+ * SPDX-FileComment: Internal header with whitelist matching helpers
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file Whitelist.hpp
+ * @brief Helpers to match OSM tags against a whitelist and to compare
+ * whitelists with each other.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "PoiOsm.hpp"
+
+namespace whitelist {
+
+/**
+ * @brief A whitelist compiled for matching many POIs.
+ *
+ * The entries are grouped by key into a hash map whose values are either a
+ * wildcard (an entry without value) or the set of accepted values. A POI is
+ * then checked with one hash lookup per tag (or one tag map probe per key
+ * if there are fewer keys than tags), independent of the number of
+ * whitelist entries, and without copying any key or value. An empty
+ * whitelist accepts everything.
+ */
+class Matcher {
+public:
+    explicit Matcher(const std::vector<PoiWhitelistEntry>& entries) : acceptsAll_(entries.empty()) {
+        for (const auto& w : entries) {
+            auto& accepted = keys_[w.key];
+            if (w.value.empty()) accepted.anyValue = true;
+            else accepted.values.insert(w.value);
+        }
+    }
+
+    /**
+     * @brief Checks whether a POI's tags satisfy at least one whitelist entry.
+     *
+     * @param tags The POI's tags (a JSON object).
+     * @return bool true if the POI is accepted.
+     */
+    bool matches(const nlohmann::json& tags) const {
+        if (acceptsAll_) return true;
+        if (!tags.is_object()) return false;
+
+        // Few distinct keys: probe the POI's tag map instead of hashing every tag
+        if (keys_.size() < tags.size()) {
+            for (const auto& [key, accepted] : keys_) {
+                auto it = tags.find(key);
+                if (it != tags.end() && accepts_(accepted, *it)) return true;
+            }
+            return false;
+        }
+
+        for (auto it = tags.begin(); it != tags.end(); ++it) {
+            auto key = keys_.find(std::string_view(it.key()));
+            if (key != keys_.end() && accepts_(key->second, *it)) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Checks whether a list of tag key/value pairs satisfies at least one whitelist entry.
+     *
+     * @param tags The POI's tags.
+     * @return bool true if the POI is accepted.
+     */
+    bool matches(const std::pmr::vector<std::pair<std::pmr::string, std::pmr::string>>& tags) const {
+        if (acceptsAll_) return true;
+
+        for (const auto& [key, value] : tags) {
+            if (accepts_(key, value)) return true;
+        }
+        return false;
+    }
+
+private:
+    struct Hash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    struct Accepted {
+        bool anyValue = false;
+        std::unordered_set<std::string, Hash, std::equal_to<>> values;
+    };
+
+    static bool accepts_(const Accepted& accepted, const nlohmann::json& value) {
+        return accepted.anyValue ||
+               (value.is_string() && accepted.values.contains(std::string_view(value.get_ref<const std::string&>())));
+    }
+
+    bool accepts_(std::string_view key, std::string_view value) const {
+        auto it = keys_.find(key);
+        return it != keys_.end() && (it->second.anyValue || it->second.values.contains(value));
+    }
+
+    bool acceptsAll_;
+    std::unordered_map<std::string, Accepted, Hash, std::equal_to<>> keys_;
+};
+
+/**
+ * @brief Checks whether every POI accepted by @p requested is also accepted by @p cached.
+ *
+ * True if @p cached is empty (accepts everything), or if each requested
+ * entry is matched by a cached entry with the same key and either the same
+ * value or no value.
+ *
+ * @param cached The whitelist a cached result was fetched with.
+ * @param requested The whitelist of the new query.
+ * @return bool true if the cached result is a superset of the requested one.
+ */
+inline bool covers(const std::vector<PoiWhitelistEntry>& cached, const std::vector<PoiWhitelistEntry>& requested) {
+    if (cached.empty()) return true;
+    if (requested.empty()) return false;
+
+    return std::ranges::all_of(requested, [&](const PoiWhitelistEntry& r) {
+        return std::ranges::any_of(cached, [&](const PoiWhitelistEntry& c) {
+            return c.key == r.key && (c.value.empty() || c.value == r.value);
+        });
+    });
+}
+
+/**
+ * @brief Returns an order-independent string form of a whitelist, for use in cache keys.
+ *
+ * @param entries The whitelist.
+ * @return std::string Sorted "key=value" pairs joined by '&'.
+ */
+inline std::string canonical(const std::vector<PoiWhitelistEntry>& entries) {
+    std::vector<std::string> parts;
+    parts.reserve(entries.size());
+    for (const auto& w : entries) parts.push_back(w.key + "=" + w.value);
+    std::ranges::sort(parts);
+
+    std::string key;
+    for (const auto& part : parts) {
+        if (!key.empty()) key += '&';
+        key += part;
+    }
+    return key;
+}
+
+} // namespace whitelist
@@ -0,0 +1,84 @@
+/**
+ * SPDX-FileComment: Main entry point of the POI store importer
+ * SPDX-FileType: SOURCE
+ * SPDX-FileContributor: ZHENG Robert
+ * SPDX-FileCopyrightText: 2026 ZHENG Robert
+ * SPDX-License-Identifier: MIT
+ *
+ * @file import_main.cpp
+ * @brief Implements get_poi-osm-import, which builds an offline POI store
+ * from an `.osm.pbf` extract and reports the import throughput.
+ * @version 0.1.0
+ * @date 2026-02-15
+ *
+ * @author ZHENG Robert
+ * @license MIT License
+ */
+
+#include <CLI/CLI.hpp>
+#include <print>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "PoiOsm.hpp"
+
+namespace {
+
+// Helper to split string by delimiter
+std::vector<std::string> split(const std::string& s, char delimiter) {
+    std::vector<std::string> tokens;
+    std::string token;
+    std::istringstream tokenStream(s);
+    while (std::getline(tokenStream, token, delimiter)) {
+        if (!token.empty()) tokens.push_back(token);
+    }
+    return tokens;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    CLI::App app{"Builds an offline POI store for get_poi-osm-cli from an OSM PBF extract"};
+    app.set_version_flag("--version", "1.0");
+
+    std::string pbfPath;
+    std::string storePath;
+    PoiImportOptions options;
+    std::string rawKeys;
+    std::size_t memoryMb = options.memoryBudget >> 20;
+    bool nodesOnly = false;
+
+    app.add_option("pbf", pbfPath, "OSM extract (.osm.pbf)")->required()->check(CLI::ExistingFile);
+    app.add_option("store", storePath, "POI store to write; an existing store is replaced")->required();
+    app.add_option("-j,--threads", options.threads, "Decoding threads (0 = one per hardware thread)")
+        ->default_val(0);
+    auto keysOpt = app.add_option("--keys", rawKeys,
+        "Comma-separated tag keys that make an element a POI; \"\" imports every tagged element");
+    app.add_option("--memory-mb", memoryMb, "Memory for buffered POIs, way node ids and node positions, in MiB")
+        ->default_val(memoryMb)
+        ->check(CLI::Range(std::size_t{1}, std::size_t{1} << 20));
+    app.add_flag("--nodes-only", nodesOnly, "Import POI nodes only, in a single pass");
+
+    CLI11_PARSE(app, argc, argv);
+
+    if (!keysOpt->empty()) options.keys = split(rawKeys, ',');
+    options.memoryBudget = memoryMb << 20;
+    options.waysAndRelations = !nodesOnly;
+
+    auto stats = PoiOsmClient::buildPoiStore(pbfPath, storePath, options);
+    if (!stats) {
+        std::println(stderr, "Import failed: {}", stats.error());
+        return 1;
+    }
+
+    std::println("Stored {} POIs in {} ({} nodes, {} ways, {} relations; {} unresolved)", stats->pois(), storePath,
+                 stats->poiNodes, stats->poiWays, stats->poiRelations, stats->unresolved);
+    std::println("Read {} nodes, {} ways, {} relations in {} blobs", stats->nodes, stats->ways, stats->relations,
+                 stats->blobs);
+    std::println("{} passes, {} blob reads, {} threads, {} spilled runs", stats->passes, stats->blobReads,
+                 stats->threads, stats->spilledRuns);
+    std::println("{:.2f} s: {:.0f} blobs/s, {:.0f} nodes/s", stats->seconds, stats->blobsPerSecond(),
+                 stats->nodesPerSecond());
+    return 0;
+}
@@ -51,12 +51,50 @@ int main(int argc, char** argv) {
     std::string address;
     std::vector<std::string> rawWhitelist;
     int radius = 100000;
+    std::string geocodeCachePath;
+    bool tiled = false;
+    int tileZoom = 10;
+    bool adaptiveSplit = false;
+    int maxSplitDepth = 4;
+    bool waysAndRelations = false;
+    std::size_t limit = 0;
+    std::string sort = "none";
+    std::size_t nearest = 0;
+    bool countOnly = false;
+    std::string rawTags;
+    std::size_t tileThreshold = 0;
+    std::string poiStorePath;
+    std::string importPbfPath;
+    std::string format = "json";
 
     auto latOpt = app.add_option("-l,--lat", lat, "Latitude");
     auto lonOpt = app.add_option("-L,--lon", lon, "Longitude");
     auto addrOpt = app.add_option("-a,--address", address, "Address");
     app.add_option("-w,--whitelist", rawWhitelist, "Whitelist entry key[=value], e.g. amenity=restaurant");
     app.add_option("-r,--radius", radius, "Search radius in meters")->default_val(100000);
+    app.add_option("-f,--format", format, "Output format: json, or ndjson (one POI per line, then a summary line)")
+        ->default_val("json")
+        ->check(CLI::IsMember({"json", "ndjson"}));
+    app.add_option("--geocode-cache", geocodeCachePath, "Persistent geocoding cache file, shared across runs");
+    app.add_flag("--tiled", tiled, "Fetch the search area as concurrent per-tile queries");
+    app.add_option("--tile-zoom", tileZoom, "Zoom level of the fetch tiles")->default_val(10)->check(CLI::Range(4, 16));
+    app.add_flag("--adaptive-split", adaptiveSplit, "Retry areas that time out or hit a busy server as smaller quadrants");
+    app.add_option("--max-split-depth", maxSplitDepth, "Maximum quadrant split levels")->default_val(4)->check(CLI::Range(1, 8));
+    app.add_flag("--nwr", waysAndRelations, "Also return ways and relations, placed at their center");
+    app.add_option("--limit", limit, "Return at most N POIs (0 = all)")->default_val(0);
+    app.add_option("--sort", sort, "POI order: none, or distance (nearest first; with --limit, the N nearest)")
+        ->default_val("none")
+        ->check(CLI::IsMember({"none", "distance"}));
+    auto tagsOpt = app.add_option("--tags", rawTags,
+        "Comma-separated tags to keep per POI besides the whitelist keys, e.g. name,opening_hours; \"\" keeps none");
+    app.add_flag("--count", countOnly, "Only count the POIs, in total and per whitelist entry");
+    app.add_option("--tile-threshold", tileThreshold, "Count first and fetch tiled above N elements (0 = never)")
+        ->default_val(0);
+    app.add_option("--nearest", nearest, "Return the N nearest POIs, widening the search from 1 km up to --radius");
+    auto storeOpt = app.add_option("--poi-store", poiStorePath,
+        "Offline POI store; queries inside its extract are answered without Overpass");
+    app.add_option("--import-pbf", importPbfPath, "Build --poi-store from an .osm.pbf extract and exit")
+        ->needs(storeOpt);
 
     // Custom validation: Either (lat AND lon) OR address must be set
     latOpt->needs(lonOpt);
@@ -64,6 +102,17 @@ int main(int argc, char** argv) {
     
     CLI11_PARSE(app, argc, argv);
 
+    if (!importPbfPath.empty()) {
+        auto imported = PoiOsmClient::buildPoiStore(importPbfPath, poiStorePath);
+        curl_global_cleanup();
+        if (!imported) {
+            std::println(stderr, "Import failed: {}", imported.error());
+            return 1;
+        }
+        std::println("Stored {} POIs in {}", imported->pois(), poiStorePath);
+        return 0;
+    }
+
     bool hasLatLon = !latOpt->empty() && !lonOpt->empty();
     bool hasAddr = !addrOpt->empty();
 
@@ -94,17 +143,71 @@ int main(int argc, char** argv) {
         }
     }
 
-    PoiOsmClient client;
+    PoiOsmClientOptions options;
+    options.tiledFetch = tiled;
+    options.tileZoom = tileZoom;
+    options.adaptiveSplit = adaptiveSplit;
+    options.maxSplitDepth = maxSplitDepth;
+    options.includeWaysAndRelations = waysAndRelations;
+    options.limit = limit;
+    options.sort = sort == "distance" ? PoiSortOrder::Distance : PoiSortOrder::None;
+    options.tileThreshold = tileThreshold;
+    if (!tagsOpt->empty()) {
+        options.tags.emplace();
+        for (auto tag : split(rawTags, ',')) {
+            tag.erase(0, tag.find_first_not_of(" \t"));
+            tag.erase(tag.find_last_not_of(" \t") + 1);
+            if (!tag.empty()) options.tags->push_back(tag);
+        }
+    }
+
+    PoiOsmClient client(std::move(options));
+    if (!geocodeCachePath.empty()) {
+        if (auto opened = client.openGeocodeStore(geocodeCachePath); !opened) {
+            std::println(stderr, "Warning: geocode cache disabled: {}", opened.error());
+        }
+    }
+    if (!poiStorePath.empty()) {
+        if (auto opened = client.openPoiStore(poiStorePath); !opened) {
+            std::println(stderr, "Warning: POI store disabled: {}", opened.error());
+        }
+    }
+
     std::expected<nlohmann::json, std::string> result;
 
-    if (hasLatLon) {
+    if (countOnly) {
+        if (hasLatLon) {
+            result = client.queryCountByCoordinates(lat, lon, radius, whitelist);
+        } else {
+            result = client.queryCountByAddress(address, radius, whitelist);
+        }
+    } else if (nearest > 0) {
+        if (hasLatLon) {
+            result = client.queryNearestByCoordinates(lat, lon, nearest, whitelist, radius);
+        } else {
+            result = client.queryNearestByAddress(address, nearest, whitelist, radius);
+        }
+        if (result && format == "ndjson") {
+            auto& results = (*result)["results"];
+            for (const auto& poi : results["pois"]) std::println("{}", poi.dump());
+            results.erase("pois");
+        }
+    } else if (format == "ndjson") {
+        // One compact POI per line as it arrives; the summary line comes last
+        auto printPoi = [](const nlohmann::json& poi) { std::println("{}", poi.dump()); };
+        if (hasLatLon) {
+            result = client.streamByCoordinates(lat, lon, radius, whitelist, printPoi);
+        } else {
+            result = client.streamByAddress(address, radius, whitelist, printPoi);
+        }
+    } else if (hasLatLon) {
         result = client.queryByCoordinates(lat, lon, radius, whitelist);
     } else {
         result = client.queryByAddress(address, radius, whitelist);
     }
 
     if (result) {
-        std::println("{}", result->dump(4)); // Pretty print
+        std::println("{}", format == "ndjson" ? result->dump() : result->dump(4)); // Pretty print
     } else {
         nlohmann::json err;
         err["schema_version"] = 1;